@@ -105,6 +105,27 @@ struct FFMODOcclusionDetails
     {}
 };
 
+/** One parameter value for UFMODAudioComponent::SetParameters. */
+USTRUCT(BlueprintType)
+struct FFMODParameterUpdate
+{
+    GENERATED_USTRUCT_BODY()
+    /** Name of the parameter. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FMOD|Parameter")
+    FName Name;
+    /** Value to set. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FMOD|Parameter")
+    float Value;
+    /** The update is skipped if the value differs from the last value set by no more than this. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FMOD|Parameter", meta = (ClampMin = "0.0", UIMin = "0.0"))
+    float Epsilon;
+
+    FFMODParameterUpdate()
+        : Value(0.0f)
+        , Epsilon(0.0f)
+    {}
+};
+
 /** called when an event stops, either because it played to completion or because a Stop() call turned it off early */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnEventStopped);
 /** called when a sound stops */
@@ -140,6 +161,7 @@ class FMODSTUDIO_API UFMODAudioComponent : public USceneComponent
 
     friend struct FFMODEventControlExecutionToken;
     friend struct FPlayingToken;
+    friend class UFMODEmitterSubsystem;
     friend FMOD_RESULT F_CALLBACK UFMODAudioComponent_EventCallback(FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE *event, void *parameters);
 
 public:
@@ -232,6 +254,17 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Audio|FMOD|Components")
     void SetParameter(FName Name, float Value);
 
+    /** Set several parameters of the Event with a single call into FMOD.
+     * Values within their epsilon of the last value set are skipped and counted by GetSuppressedParameterUpdates.
+     * @param Updates - Parameter names, values and change thresholds
+    */
+    UFUNCTION(BlueprintCallable, Category = "Audio|FMOD|Components")
+    void SetParameters(const TArray<FFMODParameterUpdate> &Updates);
+
+    /** Get the number of parameter updates SetParameters has skipped because the value hadn't changed enough. */
+    UFUNCTION(BlueprintCallable, Category = "Audio|FMOD|Components")
+    int32 GetSuppressedParameterUpdates() const;
+
     /** Will be deprecated in FMOD 2.01, use `GetParameterValue(FName, float, float)` instead.
      * Get parameter value from the Event.
     */
@@ -347,6 +380,15 @@ private:
     /** Apply Volume and LPF into event. */
     void ApplyVolumeLPF();
 
+    /** Convert the component transform and owner velocity to FMOD 3D attributes. */
+    void Get3DAttributes(FMOD_3D_ATTRIBUTES &Attributes) const;
+
+    /** Update interior volumes, attenuation and occlusion, then apply them to the event. */
+    void UpdateEnvironment();
+
+    /** Queue the component with the world's emitter subsystem, or update it immediately if the world has none. */
+    void MarkEmitterDirty(bool bTransformChanged);
+
     /** Timeline Marker callback. */
     void EventCallbackAddMarker(struct FMOD_STUDIO_TIMELINE_MARKER_PROPERTIES *props);
 
@@ -392,6 +434,9 @@ private:
     /** Check if a parameter is game controlled or automated to determine if it should be cached. */
     bool ShouldCacheParameter(const FMOD_STUDIO_PARAMETER_DESCRIPTION& ParameterDescription);
 
+    /** Look up the ID of a parameter on the current event, through the module's cache. */
+    bool FindParameterID(FName Name, FMOD_STUDIO_PARAMETER_ID &ID);
+
     /** Return a cached reference to the current IFMODStudioModule.*/
     IFMODStudioModule& GetStudioModule()
     {
@@ -431,6 +476,10 @@ private:
     FMOD_STUDIO_PARAMETER_ID AmbientVolumeID;
     /** Stored ID of the LPF parameter of the Event (if applicable). */
     FMOD_STUDIO_PARAMETER_ID AmbientLPFID;
+    /** Description the Studio instance was created from. Used to look up parameter IDs by name. */
+    FMOD::Studio::EventDescription *StudioDescription;
+    /** Number of updates SetParameters has skipped as below their epsilon. */
+    int32 SuppressedParameterUpdates;
 
     // Tempo and marker callbacks.
     /** A scope lock used specifically for callbacks. */
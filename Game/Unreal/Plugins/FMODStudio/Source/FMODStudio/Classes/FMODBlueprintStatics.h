@@ -4,6 +4,7 @@
 
 #include "FMODAudioComponent.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Engine/LatentActionManager.h"
 #include "Containers/UnrealString.h"
 #include "FMODBlueprintStatics.generated.h"
 
@@ -15,6 +16,8 @@ namespace Studio
 {
 class EventDescription;
 class EventInstance;
+class Bus;
+class VCA;
 }
 }
 
@@ -88,7 +91,21 @@ class FMODSTUDIO_API UFMODBlueprintStatics : public UBlueprintFunctionLibrary
     UFUNCTION(BlueprintCallable, Category = "Audio|FMOD")
     static UFMODEvent *FindEventByName(const FString &Name);
 
-    /** Loads a bank.
+    /** Find an asset by name without blocking, loading it in the background if needed.
+	 * @param Name - The asset name
+	 * @param Asset - The asset found, or none if there is no asset with that name
+	 */
+    UFUNCTION(BlueprintCallable, Category = "Audio|FMOD", meta = (Latent, LatentInfo = "LatentInfo", WorldContext = "WorldContextObject"))
+    static void FindAssetByNameAsync(UObject *WorldContextObject, const FString &Name, UFMODAsset *&Asset, FLatentActionInfo LatentInfo);
+
+    /** Find an event by name without blocking, loading it in the background if needed.
+	 * @param Name - The event name
+	 * @param Event - The event found, or none if there is no event with that name
+	 */
+    UFUNCTION(BlueprintCallable, Category = "Audio|FMOD", meta = (Latent, LatentInfo = "LatentInfo", WorldContext = "WorldContextObject"))
+    static void FindEventByNameAsync(UObject *WorldContextObject, const FString &Name, UFMODEvent *&Event, FLatentActionInfo LatentInfo);
+
+    /** Loads a bank. Loads are reference counted, so the bank stays loaded until each call has been matched by UnloadBank.
 	 * @param Bank - bank to load
 	 * @param bBlocking - determines whether the bank will load synchronously
 	 * @param bLoadSampleData - determines whether sample data will be preloaded immediately
@@ -96,19 +113,52 @@ class FMODSTUDIO_API UFMODBlueprintStatics : public UBlueprintFunctionLibrary
     UFUNCTION(BlueprintCallable, Category = "Audio|FMOD", meta = (UnsafeDuringActorConstruction = "true", bBlocking = "true"))
     static void LoadBank(class UFMODBank *Bank, bool bBlocking, bool bLoadSampleData);
 
-    /** Unloads a bank.
+    /** Unloads a bank, releasing one reference taken by LoadBank. The bank is unloaded once the linger time in the settings has passed.
+	 * Banks referenced by per-level loading or other native code stay loaded until those references are released too.
 	 * @param Bank - bank to unload
 	 */
     UFUNCTION(BlueprintCallable, Category = "Audio|FMOD", meta = (UnsafeDuringActorConstruction = "true"))
     static void UnloadBank(class UFMODBank *Bank);
 
+    /** Loads exactly the banks needed to play a set of events, including their sample data and stream banks.
+	 * Reference counted like LoadBank, so each call should be matched by UnloadBanksForEvents with the same events.
+	 * @param Events - events to load banks for
+	 * @param bBlocking - determines whether the banks will load synchronously
+	 */
+    UFUNCTION(BlueprintCallable, Category = "Audio|FMOD", meta = (UnsafeDuringActorConstruction = "true", bBlocking = "true"))
+    static void LoadBanksForEvents(const TArray<UFMODEvent *> &Events, bool bBlocking);
+
+    /** Unloads the banks loaded by LoadBanksForEvents.
+	 * @param Events - events passed to LoadBanksForEvents
+	 */
+    UFUNCTION(BlueprintCallable, Category = "Audio|FMOD", meta = (UnsafeDuringActorConstruction = "true"))
+    static void UnloadBanksForEvents(const TArray<UFMODEvent *> &Events);
+
+    /** Returns true once the banks loaded at startup have finished loading. */
+    UFUNCTION(BlueprintPure, Category = "Audio|FMOD")
+    static bool AreBanksLoaded();
+
+    /** Returns the fraction (0 to 1) of the banks loaded at startup that have finished loading. */
+    UFUNCTION(BlueprintPure, Category = "Audio|FMOD")
+    static float GetBankLoadProgress();
+
+    /** Returns true once the banks and sample data the current map uses have been warmed up, or if there is nothing to warm up.
+     * Requires Warm Up Map Audio in the FMOD settings. Use this to hold the start of play until the map's audio is resident.
+     */
+    UFUNCTION(BlueprintPure, Category = "Audio|FMOD")
+    static bool IsMapAudioWarmedUp();
+
+    /** Returns the fraction (0 to 1) of the events the current map uses whose sample data has been warmed up. */
+    UFUNCTION(BlueprintPure, Category = "Audio|FMOD")
+    static float GetMapAudioWarmupProgress();
+
     /** Returns true if a bank is loaded.
 	* @param Bank - bank to query
 	*/
     UFUNCTION(BlueprintCallable, Category = "Audio|FMOD", meta = (UnsafeDuringActorConstruction = "true"))
     static bool IsBankLoaded(class UFMODBank *Bank);
 
-    /** Load bank sample data.
+    /** Load bank sample data. Does nothing unless the bank is already loaded. Reference counted like LoadBank, and keeps the bank loaded until released.
 	 * @param Bank - bank to load sample data from
 	 */
     UFUNCTION(BlueprintCallable, Category = "Audio|FMOD", meta = (UnsafeDuringActorConstruction = "true"))
@@ -177,6 +227,16 @@ class FMODSTUDIO_API UFMODBlueprintStatics : public UBlueprintFunctionLibrary
     UFUNCTION(BlueprintCallable, Category = "Audio|FMOD|VCA", meta = (UnsafeDuringActorConstruction = "true"))
     static void VCASetVolume(class UFMODVCA *Vca, float Volume);
 
+    /**
+     * Overloads taking handles from IFMODStudioModule::GetBus and GetVCA, for code that drives a bus or VCA every frame.
+     * Handles are invalidated when a bank is unloaded, so fetch them again after bank changes rather than keeping them.
+     */
+    static void BusSetVolume(FMOD::Studio::Bus *Bus, float Volume);
+    static void BusSetPaused(FMOD::Studio::Bus *Bus, bool bPaused);
+    static void BusSetMute(FMOD::Studio::Bus *Bus, bool bMute);
+    static void BusStopAllEvents(FMOD::Studio::Bus *Bus, EFMOD_STUDIO_STOP_MODE stopMode);
+    static void VCASetVolume(FMOD::Studio::VCA *Vca, float Volume);
+
     /** Set a global parameter from the System.
      * @param Name - Name of parameter
      * @param Value - Value of parameter
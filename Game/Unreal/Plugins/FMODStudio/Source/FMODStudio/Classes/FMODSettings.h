@@ -161,6 +161,13 @@ struct FFMODPlatformSettings
      */
     UPROPERTY(config, EditAnywhere, Category = PlatformSettings, meta = (ClampMin = "0"))
     int32 CustomPoolSize;
+    /**
+     * Maximum sample data to keep resident, units in bytes. 0 = no limit.
+     * When exceeded, sample data for the events and banks played least recently is unloaded.
+     * Requires the custom memory pool to be disabled, as sample data allocations can't be tracked inside it.
+     */
+    UPROPERTY(config, EditAnywhere, Category = PlatformSettings, meta = (ClampMin = "0"))
+    int32 SampleDataBudget;
     /* Codecs
     */
     UPROPERTY(config, EditAnywhere, Category = PlatformSettings, meta = (ClampMin = "0"))
@@ -171,6 +178,7 @@ struct FFMODPlatformSettings
         , SpeakerMode(EFMODSpeakerMode::Surround_5_1)
         , OutputType(EFMODOutput::TYPE_AUTODETECT)
         , CustomPoolSize(0)
+        , SampleDataBudget(0)
     {}
 };
 
@@ -207,8 +215,10 @@ class FMODSTUDIO_API UFMODSettings : public UObject
     friend class FFMODStudioEditorModule;
     friend class FFMODAssetTable;
     friend class FFMODStudioModule;
+    friend class FFMODSampleDataBudget;
     friend class FFMODAssetBuilder;
     friend class UFMODGenerateAssetsCommandlet;
+    friend class UFMODGenerateMapManifestsCommandlet;
 
 public:
     /**
@@ -223,6 +233,52 @@ public:
     UPROPERTY(config, EditAnywhere, Category = Basic)
     bool bLoadAllSampleData;
 
+    /**
+     * Whether to memory map bank files for the runtime system rather than reading them through the file system.
+     * Only applies to banks staged outside of pak files; other banks are loaded from file as normal.
+     */
+    UPROPERTY(config, EditAnywhere, Category = Basic)
+    bool bMemoryMapBanks;
+
+    /**
+     * Load the runtime banks without blocking the game thread.
+     * Loading is polled each tick; use the module's bank load delegates or Are Banks Loaded to find out when it has finished.
+     * Has no effect when Lock All Buses is enabled, as that requires the banks to be loaded synchronously.
+     */
+    UPROPERTY(config, EditAnywhere, Category = Basic)
+    bool bAsyncBankLoading;
+
+    /**
+     * Load banks for the events referenced by the levels in the game world, rather than loading all banks at startup.
+     * Banks are loaded and unloaded as levels and World Partition cells stream in and out. Overrides Load All Banks at runtime.
+     * Audio components spawned at runtime, including those played by animation notifies, load their banks as they register,
+     * and wait for them if they play before the load has finished. Events played without a component, such as through
+     * Play Event 2D or Play Event At Location, are only found if another level already uses them.
+     */
+    UPROPERTY(config, EditAnywhere, Category = Basic)
+    bool bLoadBanksPerLevel;
+
+    /**
+     * Whether to also load sample data for the events referenced by each level when loading banks per level.
+     */
+    UPROPERTY(config, EditAnywhere, Category = Basic, meta = (EditCondition = "bLoadBanksPerLevel"))
+    bool bLoadLevelEventSampleData;
+
+    /**
+     * Seconds a bank loaded through LoadBank, or its sample data, stays resident after the last reference to it is released.
+     * A bank that is loaded again within this time is reused rather than reloaded from disk. Set to zero to unload immediately.
+     */
+    UPROPERTY(config, EditAnywhere, Category = Basic, meta = (ClampMin = "0", Units = "s"))
+    float BankUnloadLingerTime;
+
+    /**
+     * Load the banks and event sample data a map uses in the background as soon as the map starts loading.
+     * Requires the manifests written by the FMODGenerateMapManifests commandlet. Events that still play before their
+     * sample data has loaded are reported in the log when the map is left.
+     */
+    UPROPERTY(config, EditAnywhere, Category = Basic)
+    bool bWarmUpMapAudio;
+
     /**
      * Enable live update in non-final builds.
      */
@@ -257,6 +313,13 @@ public:
     UPROPERTY(config, EditAnywhere, Category = Localization)
     TArray<FFMODProjectLocale> Locales;
 
+    /**
+     * Seconds a locale change waits for instances of a localized bank's events to finish before swapping the bank.
+     * Instances still playing after this time are stopped when the old bank is unloaded.
+     */
+    UPROPERTY(config, EditAnywhere, Category = Localization, meta = (ClampMin = "0", Units = "s"))
+    float LocaleSwapDrainTime;
+
     /**
      * The signal level at which channels are virtualized. Virtual channels are processed, but do not produce any output.
      */
@@ -308,6 +371,41 @@ public:
     UPROPERTY(config, EditAnywhere, Category = InitSettings)
     int32 FileBufferSize;
 
+    /**
+     * Number of worker threads servicing FMOD file access (2 by default).
+     * Reads on different files are handled concurrently, up to this many at once.
+     */
+    UPROPERTY(config, EditAnywhere, Category = InitSettings, meta = (ClampMin = "1", ConfigRestartRequired = true))
+    int32 FileThreadCount;
+
+    /**
+     * Service FMOD stream and sample data reads with asynchronous file requests instead of blocking reads.
+     * Allows many reads to be outstanding at once, prioritized and cancelled by FMOD.
+     */
+    UPROPERTY(config, EditAnywhere, Category = InitSettings)
+    bool bEnableAsyncFileReads;
+
+    /**
+     * Size in bytes of the read-ahead blocks cached for each open file (32768 by default).
+     * Small reads are coalesced into block sized reads, and reads at least this large bypass the cache. Set to 0 to disable the cache.
+     */
+    UPROPERTY(config, EditAnywhere, Category = InitSettings, meta = (ClampMin = "0"))
+    int32 FileCacheBlockSize;
+
+    /**
+     * Number of read-ahead blocks cached for each open file (4 by default).
+     * The least recently used block is replaced on a miss.
+     */
+    UPROPERTY(config, EditAnywhere, Category = InitSettings, meta = (ClampMin = "1"))
+    int32 FileCacheBlockCount;
+
+    /**
+     * Time in milliseconds within which a stream refill should be serviced (20 by default).
+     * File requests are scheduled earliest deadline first; programmer sounds, bank metadata and sample data get 2, 5 and 10 times longer.
+     */
+    UPROPERTY(config, EditAnywhere, Category = InitSettings, meta = (ClampMin = "1"))
+    int32 FileStreamDeadlineMs;
+
     /**
      * Studio update period in milliseconds, or 0 for default (which means 20ms).
      */
@@ -322,6 +420,8 @@ public:
 
     /**
      * Lock all mixer buses at startup, making sure they are created up front.
+     * Runtime banks wait for the asset table to load in the background, so the banks are loaded and the buses locked on
+     * the first tick after that, or as soon as an event, bus, VCA or global parameter is looked up if that is sooner.
      */
     UPROPERTY(config, EditAnywhere, Category = InitSettings)
     bool bLockAllBuses;
@@ -353,6 +453,14 @@ public:
     UPROPERTY(config, EditAnywhere, Category = Advanced)
     int32 ReloadBanksDelay;
 
+    /**
+    * When banks are reloaded automatically, reload only the bank files that changed and keep the editor system running,
+    * instead of recreating the Studio systems and reloading every bank. Off by default.
+    * Changes to the master or strings banks, and removed bank files, still reload every bank.
+    */
+    UPROPERTY(config, EditAnywhere, Category = Advanced, meta = (EditCondition = "ReloadBanksDelay > 0"))
+    bool bIncrementalBankReload;
+
     /**
      * Will log internal API errors when enabled.
      */
@@ -365,6 +473,19 @@ public:
     UPROPERTY(config, EditAnywhere, Category = Advanced)
     bool bEnableMemoryTracking;
 
+    /**
+     * Record the order in which FMOD reads bank data while each map is played.
+     * Traces are saved per map to Saved/FMOD/IOTraces when the next map loads or the game exits.
+     */
+    UPROPERTY(config, EditAnywhere, Category = Advanced)
+    bool bRecordFileAccessTraces;
+
+    /**
+     * Prefetch bank data in the background while a map loads, using the trace previously recorded for that map.
+     */
+    UPROPERTY(config, EditAnywhere, Category = Advanced)
+    bool bPrefetchFromFileAccessTraces;
+
     /**
      * Extra plugin files to load.
      * The plugin files should sit alongside the FMOD dynamic libraries in the ThirdParty directory.
@@ -476,6 +597,9 @@ private:
     /** Get the custom memory pool size for the current platform. */
     int32 GetMemoryPoolSize() const;
 
+    /** Get the sample data budget for the current platform, 0 if unlimited. */
+    int32 GetSampleDataBudget() const;
+
     /** Get the real channel count for the current platform. */
     int32 GetRealChannelCount() const;
 
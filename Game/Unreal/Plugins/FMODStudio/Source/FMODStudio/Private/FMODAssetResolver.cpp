@@ -0,0 +1,143 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODAssetResolver.h"
+#include "FMODAssetTable.h"
+#include "FMODAsset.h"
+#include "FMODStudioPrivatePCH.h"
+
+FFMODAssetResolver::FFMODAssetResolver(const FFMODAssetTable &InAssetTable)
+    : AssetTable(InAssetTable)
+{
+}
+
+UFMODAsset *FFMODAssetResolver::Find(const FString &StudioPath)
+{
+    FSoftObjectPath AssetPath;
+    if (UFMODAsset *Asset = FindCached(StudioPath, AssetPath))
+    {
+        return Asset;
+    }
+
+    if (AssetPath.IsNull())
+    {
+        return nullptr;
+    }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Loading %s on the game thread, use FindAssetByNameAsync to avoid blocking"), *StudioPath);
+
+    UFMODAsset *Asset = Cast<UFMODAsset>(AssetPath.TryLoad());
+    if (Asset)
+    {
+        Cache.Add(StudioPath, Asset);
+    }
+    return Asset;
+}
+
+void FFMODAssetResolver::FindAsync(const FString &StudioPath, FFMODAssetFound Callback)
+{
+    if (AssetTable.IsLoading())
+    {
+        QueuedFinds.Emplace(StudioPath, MoveTemp(Callback));
+        return;
+    }
+
+    FSoftObjectPath AssetPath;
+    UFMODAsset *Asset = FindCached(StudioPath, AssetPath);
+    if (Asset || AssetPath.IsNull())
+    {
+        Callback.ExecuteIfBound(Asset);
+        return;
+    }
+
+    if (FPendingLoad *Pending = PendingLoads.Find(StudioPath))
+    {
+        Pending->Callbacks.Add(MoveTemp(Callback));
+        return;
+    }
+
+    // Added before the request, since the completion delegate may run before RequestAsyncLoad returns
+    PendingLoads.Add(StudioPath).Callbacks.Add(MoveTemp(Callback));
+
+    TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(AssetPath,
+        FStreamableDelegate::CreateRaw(this, &FFMODAssetResolver::OnLoaded, StudioPath), FStreamableManager::AsyncLoadHighPriority);
+
+    if (FPendingLoad *Pending = PendingLoads.Find(StudioPath))
+    {
+        Pending->Handle = Handle;
+    }
+}
+
+void FFMODAssetResolver::ClearCache()
+{
+    Cache.Reset();
+}
+
+void FFMODAssetResolver::Tick()
+{
+    if (QueuedFinds.Num() == 0 || AssetTable.IsLoading())
+    {
+        return;
+    }
+
+    // Moved out first, since a callback may queue another find
+    TArray<TPair<FString, FFMODAssetFound>> Finds = MoveTemp(QueuedFinds);
+    for (TPair<FString, FFMODAssetFound> &Find : Finds)
+    {
+        FindAsync(Find.Key, MoveTemp(Find.Value));
+    }
+}
+
+UFMODAsset *FFMODAssetResolver::FindCached(const FString &StudioPath, FSoftObjectPath &AssetPath)
+{
+    if (const TWeakObjectPtr<UFMODAsset> *Cached = Cache.Find(StudioPath))
+    {
+        if (UFMODAsset *Asset = Cached->Get())
+        {
+            return Asset;
+        }
+        Cache.Remove(StudioPath);
+    }
+
+    AssetPath = AssetTable.GetAssetPathByStudioPath(StudioPath);
+    if (AssetPath.IsNull())
+    {
+        return nullptr;
+    }
+
+    // Assets referenced elsewhere are usually loaded already, in which case there is nothing to wait for
+    UFMODAsset *Asset = Cast<UFMODAsset>(AssetPath.ResolveObject());
+    if (Asset)
+    {
+        Cache.Add(StudioPath, Asset);
+    }
+    return Asset;
+}
+
+void FFMODAssetResolver::OnLoaded(FString StudioPath)
+{
+    FPendingLoad Pending;
+    if (!PendingLoads.RemoveAndCopyValue(StudioPath, Pending))
+    {
+        return;
+    }
+
+    UFMODAsset *Asset = Pending.Handle.IsValid() ? Cast<UFMODAsset>(Pending.Handle->GetLoadedAsset()) : nullptr;
+    if (!Asset)
+    {
+        Asset = Cast<UFMODAsset>(AssetTable.GetAssetPathByStudioPath(StudioPath).ResolveObject());
+    }
+
+    if (Asset)
+    {
+        Cache.Add(StudioPath, Asset);
+    }
+    else
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("Failed to load the asset for %s"), *StudioPath);
+    }
+
+    for (FFMODAssetFound &Callback : Pending.Callbacks)
+    {
+        Callback.ExecuteIfBound(Asset);
+    }
+}
@@ -0,0 +1,54 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "FMODStudioModule.h"
+
+class FFMODAssetTable;
+
+/**
+ * Resolves Studio paths to assets, caching the result so each path is only looked up once. Assets can be loaded in
+ * the background through streamable handles, with every request for the same path sharing one load. Background finds
+ * made while the asset table is still loading are queued until it is ready.
+ */
+class FFMODAssetResolver
+{
+public:
+    FFMODAssetResolver(const FFMODAssetTable &InAssetTable);
+
+    /** Find an asset, loading it on the calling thread if it isn't already loaded */
+    UFMODAsset *Find(const FString &StudioPath);
+
+    /** Find an asset without blocking. Callback is called on the game thread, immediately if the asset is already loaded */
+    void FindAsync(const FString &StudioPath, FFMODAssetFound Callback);
+
+    /** Forget resolved paths, called when the asset table is reloaded */
+    void ClearCache();
+
+    /** Start finds queued while the asset table was loading */
+    void Tick();
+
+private:
+    struct FPendingLoad
+    {
+        TSharedPtr<FStreamableHandle> Handle;
+        TArray<FFMODAssetFound> Callbacks;
+    };
+
+    UFMODAsset *FindCached(const FString &StudioPath, FSoftObjectPath &AssetPath);
+    void OnLoaded(FString StudioPath);
+
+    const FFMODAssetTable &AssetTable;
+    FStreamableManager StreamableManager;
+
+    /** Resolved assets by Studio path. Weak so that cached assets can still be garbage collected */
+    TMap<FString, TWeakObjectPtr<UFMODAsset>> Cache;
+
+    /** Background loads in progress by Studio path */
+    TMap<FString, FPendingLoad> PendingLoads;
+
+    /** Finds requested before the asset table finished loading */
+    TArray<TPair<FString, FFMODAssetFound>> QueuedFinds;
+};
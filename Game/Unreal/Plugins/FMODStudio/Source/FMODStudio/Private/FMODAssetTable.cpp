@@ -9,20 +9,27 @@
 #include "FMODBank.h"
 #include "FMODBankLookup.h"
 #include "FMODBus.h"
+#include "FMODCompactLookup.h"
 #include "FMODVCA.h"
 #include "FMODUtils.h"
 #include "FMODSettings.h"
 #include "FMODFileCallbacks.h"
+#include "FMODMapManifest.h"
 #include "FMODStudioPrivatePCH.h"
 #include "fmod_studio.hpp"
 #include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
 #include "Misc/Paths.h"
 #include "UObject/Package.h"
 
 FFMODAssetTable::FFMODAssetTable()
     : ActiveLocale(FString()),
+      CompactLookup(nullptr),
       BankLookup(nullptr),
-      AssetLookup(nullptr)
+      AssetLookup(nullptr),
+      MapManifests(nullptr),
+      PendingPackages(0),
+      bLoaded(false)
 {
 }
 
@@ -30,6 +37,11 @@ void FFMODAssetTable::AddReferencedObjects(FReferenceCollector& Collector)
 {
     // The garbage collector will clean up any objects which aren't referenced, doing this tells the garbage collector our lookups are referenced
     // (the GC knows not to remove objects referenced by a UPROPERTY, doing this manually is required because our members aren't UPROPERTYs)
+    if (CompactLookup)
+    {
+        Collector.AddReferencedObject(CompactLookup);
+    }
+
     if (BankLookup)
     {
         Collector.AddReferencedObject(BankLookup);
@@ -39,84 +51,250 @@ void FFMODAssetTable::AddReferencedObjects(FReferenceCollector& Collector)
     {
         Collector.AddReferencedObject(AssetLookup);
     }
+
+    if (MapManifests)
+    {
+        Collector.AddReferencedObject(MapManifests);
+    }
 }
 
 void FFMODAssetTable::Load()
 {
+    LoadAsync();
+    WaitForLoad();
+}
+
+void FFMODAssetTable::LoadAsync()
+{
+    // A load already in progress is finished first, so its callbacks can't land in the middle of this one
+    WaitForLoad();
+
     const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
     FString PackagePath = Settings.GetFullContentPath() / PrivateDataPath();
 
-    FString PackageName = PackagePath + BankLookupName();
-    UPackage *Package = CreatePackage(*PackageName);
-    Package->FullyLoad();
-    BankLookup = FindObject<UFMODBankLookup>(Package, *BankLookupName(), true);
-
-    if (BankLookup)
+    CompactLookup = nullptr;
+    BankLookup = nullptr;
+    AssetLookup = nullptr;
+    MapManifests = nullptr;
+    BankPathIndex.Reset();
+    EventBankIndex.Reset();
+    RequestIds.Reset();
+    bLoaded = false;
+
+    // Lookups generated before the compact format existed only have the DataTables
+    if (FPackageName::DoesPackageExist(PackagePath + CompactLookupName()))
     {
-        UE_LOG(LogFMOD, Display, TEXT("Loaded bank lookup"));
+        RequestPackage(PackagePath, CompactLookupName());
     }
     else
     {
-        TCHAR msg[] = TEXT("Failed to load bank lookup");
-        if (IsRunningCommandlet())
+        RequestPackage(PackagePath, BankLookupName());
+        RequestPackage(PackagePath, AssetLookupName());
+    }
+
+    // Manifests are optional, they only exist once the FMODGenerateMapManifests commandlet has been run
+    if (FPackageName::DoesPackageExist(PackagePath + MapManifestsName()))
+    {
+        RequestPackage(PackagePath, MapManifestsName());
+    }
+}
+
+bool FFMODAssetTable::IsLoading() const
+{
+    return PendingPackages > 0;
+}
+
+bool FFMODAssetTable::IsLoaded() const
+{
+    return bLoaded;
+}
+
+void FFMODAssetTable::WaitForLoad() const
+{
+    if (!IsLoading())
+    {
+        return;
+    }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Waiting for the asset table to load"));
+
+    // Finishing can start another request, when the compact lookup has to fall back to the DataTables
+    while (IsLoading())
+    {
+        TArray<int32> Requests = RequestIds;
+        for (int32 RequestId : Requests)
         {
-            // If we're running in a commandlet (maybe we're cooking or running FMODGenerateAssets
-            // commandlet) Display a message but don't cause the build to Error out.
-            UE_LOG(LogFMOD, Display, msg);
+            FlushAsyncLoading(RequestId);
         }
-        else
+    }
+}
+
+void FFMODAssetTable::RequestPackage(const FString &PackagePath, const FString &AssetName)
+{
+    // Counted before the request, in case the completion callback runs before LoadPackageAsync returns
+    ++PendingPackages;
+    int32 RequestId = LoadPackageAsync(PackagePath + AssetName,
+        FLoadPackageAsyncDelegate::CreateRaw(this, &FFMODAssetTable::OnPackageLoaded, AssetName));
+    RequestIds.Add(RequestId);
+}
+
+void FFMODAssetTable::OnPackageLoaded(const FName &PackageName, UPackage *Package, EAsyncLoadingResult::Type Result, FString AssetName)
+{
+    // Each object is held as soon as its package has loaded, so it can't be collected while the others finish
+    if (Package && Result == EAsyncLoadingResult::Succeeded)
+    {
+        if (AssetName == CompactLookupName())
         {
-            // If we're running in game or in editor, log this as an Error
-            UE_LOG(LogFMOD, Error, msg);
+            CompactLookup = FindObject<UFMODCompactLookup>(Package, *AssetName, true);
+        }
+        else if (AssetName == BankLookupName())
+        {
+            BankLookup = FindObject<UFMODBankLookup>(Package, *AssetName, true);
+        }
+        else if (AssetName == AssetLookupName())
+        {
+            AssetLookup = FindObject<UDataTable>(Package, *AssetName, true);
+        }
+        else if (AssetName == MapManifestsName())
+        {
+            MapManifests = FindObject<UDataTable>(Package, *AssetName, true);
         }
     }
 
-    PackageName = PackagePath + AssetLookupName();
-    Package = CreatePackage(*PackageName);
-    Package->FullyLoad();
-    AssetLookup = FindObject<UDataTable>(Package, *AssetLookupName(), true);
+    if (--PendingPackages == 0)
+    {
+        FinishLoad();
+    }
+}
 
-    if (AssetLookup)
+void FFMODAssetTable::FinishLoad()
+{
+    if (CompactLookup && !CompactLookup->IsValidLookup())
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("Compact lookup is out of date, regenerate the FMOD assets"));
+        CompactLookup = nullptr;
+
+        FString PackagePath = GetDefault<UFMODSettings>()->GetFullContentPath() / PrivateDataPath();
+        RequestPackage(PackagePath, BankLookupName());
+        RequestPackage(PackagePath, AssetLookupName());
+        return;
+    }
+
+    if (CompactLookup)
     {
-        UE_LOG(LogFMOD, Display, TEXT("Loaded asset lookup"));
+        UE_LOG(LogFMOD, Display, TEXT("Loaded compact lookup with %d assets and %d banks"), CompactLookup->GetAssetCount(), CompactLookup->GetBankCount());
     }
     else
     {
-        TCHAR msg[] = TEXT("Failed to load asset lookup");
-        if (IsRunningCommandlet())
-        {
-            // If we're running in a commandlet (maybe we're cooking or running FMODGenerateAssets
-            // commandlet) Display a message but don't cause the build to Error out.
-            UE_LOG(LogFMOD, Display, msg);
-        }
-        else
-        {
-            // If we're running in game or in editor, log this as an Error
-            UE_LOG(LogFMOD, Error, msg);
-        }
+        LogLookupLoaded(BankLookup != nullptr, TEXT("bank lookup"));
+        LogLookupLoaded(AssetLookup != nullptr, TEXT("asset lookup"));
     }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("%s map manifests"), MapManifests ? TEXT("Loaded") : TEXT("No"));
+
+    BuildBankPathIndex();
+    BuildEventBankIndex();
+    RequestIds.Reset();
+    bLoaded = true;
 }
 
-FString FFMODAssetTable::GetBankPathByGuid(const FGuid& Guid) const
+void FFMODAssetTable::LogLookupLoaded(bool bLoadedLookup, const TCHAR *LookupName)
 {
-    FString BankPath;
+    if (bLoadedLookup)
+    {
+        UE_LOG(LogFMOD, Display, TEXT("Loaded %s"), LookupName);
+    }
+    else if (IsRunningCommandlet())
+    {
+        // If we're running in a commandlet (maybe we're cooking or running FMODGenerateAssets
+        // commandlet) Display a message but don't cause the build to Error out.
+        UE_LOG(LogFMOD, Display, TEXT("Failed to load %s"), LookupName);
+    }
+    else
+    {
+        // If we're running in game or in editor, log this as an Error
+        UE_LOG(LogFMOD, Error, TEXT("Failed to load %s"), LookupName);
+    }
+}
 
-    if (!BankLookup)
+bool FFMODAssetTable::IsBankLookupLoaded() const
+{
+    return CompactLookup != nullptr || BankLookup != nullptr;
+}
+
+void FFMODAssetTable::BuildBankPathIndex()
+{
+    BankPathIndex.Reset();
+
+    if (!IsBankLookupLoaded())
     {
-        UE_LOG(LogFMOD, Error, TEXT("Bank lookup not loaded"));
-        return BankPath;
+        return;
+    }
+
+    const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+    FString BankDirectory = Settings.GetFullBankPath();
+    FString MasterBankFilename = Settings.GetMasterBankFilename();
+    FString MasterAssetsBankFilename = Settings.GetMasterAssetsBankFilename();
+    FString MasterStringsBankFilename = Settings.GetMasterStringsBankFilename();
+
+    auto AddBankPath = [&](const FGuid &Guid, FString BankPath) {
+        FBankPath &Entry = BankPathIndex.Add(Guid);
+        Entry.FullPath = BankDirectory / BankPath;
+        Entry.bIsMasterBank = (BankPath == MasterBankFilename || BankPath == MasterAssetsBankFilename || BankPath == MasterStringsBankFilename);
+        Entry.Path = MoveTemp(BankPath);
+    };
+
+    if (CompactLookup)
+    {
+        CompactLookup->ForEachBank(ActiveLocale, [&](const FGuid &Guid, const FString &BankPath) {
+            if (!BankPath.IsEmpty())
+            {
+                AddBankPath(Guid, BankPath);
+            }
+        });
+
+        UE_LOG(LogFMOD, Verbose, TEXT("Indexed %d bank paths for locale \"%s\""), BankPathIndex.Num(), *ActiveLocale);
+        return;
     }
 
-    FString GUID = Guid.ToString(EGuidFormats::DigitsWithHyphensInBraces);
-    FName BankTableName(*GUID);
-    FFMODLocalizedBankTable *BankTable = BankLookup->DataTable->FindRow<FFMODLocalizedBankTable>(BankTableName, nullptr, false);
+    // Row order is kept, so GetAllBankPaths returns the banks in the same order as the lookup
+    BankLookup->DataTable->ForeachRow<FFMODLocalizedBankTable>(nullptr, [&](const FName &RowName, const FFMODLocalizedBankTable &OuterRow) {
+        FGuid Guid;
+        FString BankPath = GetLocalizedBankPath(OuterRow.Banks);
+
+        // Never expect to be in here, but should skip empty paths
+        if (BankPath.IsEmpty() || !FGuid::Parse(RowName.ToString(), Guid))
+        {
+            return;
+        }
+
+        AddBankPath(Guid, MoveTemp(BankPath));
+    });
 
-    if (BankTable)
+    UE_LOG(LogFMOD, Verbose, TEXT("Indexed %d bank paths for locale \"%s\""), BankPathIndex.Num(), *ActiveLocale);
+}
+
+void FFMODAssetTable::BuildEventBankIndex()
+{
+    EventBankIndex.Reset();
+
+    if (!BankLookup || !BankLookup->EventBanks)
     {
-        BankPath = GetLocalizedBankPath(BankTable->Banks);
+        return;
     }
-    
-    return BankPath;
+
+    BankLookup->EventBanks->ForeachRow<FFMODEventBanksRow>(nullptr, [this](const FName &RowName, const FFMODEventBanksRow &Row) {
+        FGuid Guid;
+        if (FGuid::Parse(RowName.ToString(), Guid))
+        {
+            EventBankIndex.Add(Guid, Row.Banks);
+        }
+    });
+}
+
+const FFMODAssetTable::FBankPath *FFMODAssetTable::FindBankPath(const FGuid& Guid) const
+{
+    return BankPathIndex.Find(Guid);
 }
 
 FString FFMODAssetTable::GetLocalizedBankPath(const UDataTable* BankTable) const
@@ -142,34 +320,67 @@ FString FFMODAssetTable::GetLocalizedBankPath(const UDataTable* BankTable) const
 
 FString FFMODAssetTable::GetBankPath(const UFMODBank &Bank) const
 {
-    FString BankPath = GetBankPathByGuid(Bank.AssetGuid);
+    WaitForLoad();
 
-    if (BankPath.IsEmpty())
+    if (!IsBankLookupLoaded())
+    {
+        UE_LOG(LogFMOD, Error, TEXT("Bank lookup not loaded"));
+        return FString();
+    }
+
+    const FBankPath *Entry = FindBankPath(Bank.AssetGuid);
+
+    if (!Entry)
     {
         UE_LOG(LogFMOD, Warning, TEXT("Could not find disk file for bank %s"), *Bank.GetName());
+        return FString();
     }
 
-    return BankPath;
+    return Entry->Path;
 }
 
 FString FFMODAssetTable::GetMasterBankPath() const
 {
+    WaitForLoad();
+
+    if (CompactLookup)
+    {
+        return CompactLookup->GetMasterBankPath();
+    }
     return BankLookup ? BankLookup->MasterBankPath : FString();
 }
 
 FString FFMODAssetTable::GetMasterStringsBankPath() const
 {
+    WaitForLoad();
+
+    if (CompactLookup)
+    {
+        return CompactLookup->GetMasterStringsBankPath();
+    }
     return BankLookup ? BankLookup->MasterStringsBankPath : FString();
 }
 
 FString FFMODAssetTable::GetMasterAssetsBankPath() const
 {
+    WaitForLoad();
+
+    if (CompactLookup)
+    {
+        return CompactLookup->GetMasterAssetsBankPath();
+    }
     return BankLookup ? BankLookup->MasterAssetsBankPath : FString();
 }
 
 void FFMODAssetTable::SetLocale(const FString &LocaleCode)
 {
     ActiveLocale = LocaleCode;
+
+    // The index is built for the active locale once loading finishes
+    if (!IsLoading())
+    {
+        BuildBankPathIndex();
+    }
 }
 
 FString FFMODAssetTable::GetLocale() const
@@ -179,53 +390,144 @@ FString FFMODAssetTable::GetLocale() const
 
 void FFMODAssetTable::GetAllBankPaths(TArray<FString> &Paths, bool IncludeMasterBank) const
 {
-    if (BankLookup)
-    {
-        const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+    WaitForLoad();
 
-        BankLookup->DataTable->ForeachRow<FFMODLocalizedBankTable>(nullptr, [this, &Paths, IncludeMasterBank, &Settings](const FName &, const FFMODLocalizedBankTable& OuterRow) {
-            FString BankPath = GetLocalizedBankPath(OuterRow.Banks);
-            bool Skip = false;
+    if (IsBankLookupLoaded())
+    {
+        Paths.Reserve(Paths.Num() + BankPathIndex.Num());
 
-            if (BankPath.IsEmpty())
+        for (const TPair<FGuid, FBankPath> &Pair : BankPathIndex)
+        {
+            if (IncludeMasterBank || !Pair.Value.bIsMasterBank)
             {
-                // Never expect to be in here, but should skip empty paths
-                return;
+                Paths.Push(Pair.Value.FullPath);
             }
+        }
+    }
+    else
+    {
+        UE_LOG(LogFMOD, Error, TEXT("Bank lookup not loaded"));
+    }
+}
+
+void FFMODAssetTable::GetBankPathsByGuid(TMap<FGuid, FString> &Paths) const
+{
+    WaitForLoad();
+
+    Paths.Reserve(Paths.Num() + BankPathIndex.Num());
+
+    for (const TPair<FGuid, FBankPath> &Pair : BankPathIndex)
+    {
+        Paths.Add(Pair.Key, Pair.Value.FullPath);
+    }
+}
+
+bool FFMODAssetTable::GetEventBankPaths(const FGuid &EventGuid, TArray<FString> &Paths) const
+{
+    WaitForLoad();
+
+    TArray<FGuid> CompactBanks;
+    const TArray<FGuid> *Banks = nullptr;
 
-            if (!IncludeMasterBank)
+    // Lookups built before event dependencies were recorded don't have them
+    if (CompactLookup)
+    {
+        if (!CompactLookup->HasEventBanks())
+        {
+            return false;
+        }
+        if (CompactLookup->FindEventBanks(EventGuid, CompactBanks))
+        {
+            Banks = &CompactBanks;
+        }
+    }
+    else if (!BankLookup || !BankLookup->EventBanks)
+    {
+        return false;
+    }
+    else
+    {
+        Banks = EventBankIndex.Find(EventGuid);
+    }
+
+    if (Banks)
+    {
+        for (const FGuid &BankGuid : *Banks)
+        {
+            if (const FBankPath *Entry = FindBankPath(BankGuid))
             {
-                Skip = (BankPath == Settings.GetMasterBankFilename() || BankPath == Settings.GetMasterAssetsBankFilename() || BankPath == Settings.GetMasterStringsBankFilename());
+                Paths.AddUnique(Entry->FullPath);
             }
+        }
+    }
+
+    return true;
+}
+
+bool FFMODAssetTable::GetMapManifest(const FString &MapName, TArray<FGuid> &Events, TArray<FString> &BankPaths) const
+{
+    WaitForLoad();
+
+    if (!MapManifests)
+    {
+        return false;
+    }
 
-            if (!Skip)
+    FFMODMapManifestRow *Row = MapManifests->FindRow<FFMODMapManifestRow>(FName(*MapName), nullptr, false);
+
+    // Maps opened by short name are matched against the short name of each manifest
+    if (!Row && FPackageName::IsShortPackageName(MapName))
+    {
+        for (const TPair<FName, uint8 *> &Pair : MapManifests->GetRowMap())
+        {
+            if (FPackageName::GetShortName(Pair.Key) == MapName)
             {
-                Paths.Push(Settings.GetFullBankPath() / BankPath);
+                Row = reinterpret_cast<FFMODMapManifestRow *>(Pair.Value);
+                break;
             }
-        });
+        }
     }
-    else
+
+    if (!Row)
     {
-        UE_LOG(LogFMOD, Error, TEXT("Bank lookup not loaded"));
+        return false;
+    }
+
+    Events.Append(Row->Events);
+    for (const FGuid &BankGuid : Row->Banks)
+    {
+        if (const FBankPath *Entry = FindBankPath(BankGuid))
+        {
+            BankPaths.AddUnique(Entry->FullPath);
+        }
     }
+
+    return true;
 }
 
-UFMODAsset *FFMODAssetTable::GetAssetByStudioPath(const FString &InStudioPath) const
+FSoftObjectPath FFMODAssetTable::GetAssetPathByStudioPath(const FString &InStudioPath) const
 {
-    UFMODAsset *Asset = nullptr;
+    WaitForLoad();
 
-    if (AssetLookup)
+    FSoftObjectPath AssetPath;
+
+    if (CompactLookup)
+    {
+        FString PackageName, AssetName;
+        if (CompactLookup->FindAsset(InStudioPath, PackageName, AssetName))
+        {
+            AssetPath = FSoftObjectPath(PackageName + TEXT(".") + AssetName);
+        }
+    }
+    else if (AssetLookup)
     {
         FFMODAssetLookupRow *Row = AssetLookup->FindRow<FFMODAssetLookupRow>(FName(*InStudioPath), nullptr);
 
         if (Row)
         {
-            UPackage *Package = CreatePackage(*(Row->PackageName));
-            Package->FullyLoad();
-            Asset = FindObject<UFMODAsset>(Package, *(Row->AssetName));
+            AssetPath = FSoftObjectPath(Row->PackageName + TEXT(".") + Row->AssetName);
         }
-
     }
 
-    return Asset;
+    return AssetPath;
 }
@@ -3,11 +3,14 @@
 #pragma once
 
 #include "UObject/GCObject.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/UObjectGlobals.h"
 
 class UDataTable;
 class UFMODAsset;
 class UFMODBank;
 class UFMODBankLookup;
+class UFMODCompactLookup;
 
 class FFMODAssetTable : public FGCObject
 {
@@ -21,8 +24,17 @@ public:
         return TEXT("FFMODAssetTable");
     }
 
+    /** Load the lookups, blocking until they have loaded */
     void Load();
 
+    /** Start loading the lookups in the background. Queries made before loading finishes wait for it */
+    void LoadAsync();
+    bool IsLoading() const;
+
+    /** True once the lookups have been loaded, or found to be missing */
+    bool IsLoaded() const;
+    void WaitForLoad() const;
+
     FString GetBankPath(const UFMODBank &Bank) const;
     FString GetMasterBankPath() const;
     FString GetMasterStringsBankPath() const;
@@ -31,17 +43,60 @@ public:
     FString GetLocale() const;
     void GetAllBankPaths(TArray<FString> &BankPaths, bool IncludeMasterBank) const;
 
-    UFMODAsset *GetAssetByStudioPath(const FString &InStudioPath) const;
+    /** Get the full path of every bank for the active locale, by bank GUID */
+    void GetBankPathsByGuid(TMap<FGuid, FString> &Paths) const;
+
+    /** Add the full paths of the banks an event needs to Paths. Returns false if the bank lookup has no event dependencies */
+    bool GetEventBankPaths(const FGuid &EventGuid, TArray<FString> &Paths) const;
+
+    /** Get the events in a map's manifest and the full paths of their banks. Returns false if the map has no manifest */
+    bool GetMapManifest(const FString &MapName, TArray<FGuid> &Events, TArray<FString> &BankPaths) const;
+
+    /** Get the object path of the asset for a Studio path, or an empty path if there is no such asset */
+    FSoftObjectPath GetAssetPathByStudioPath(const FString &InStudioPath) const;
 
     static inline FString PrivateDataPath() { return FString(TEXT("PrivateIntegrationData/")); }
     static inline FString BankLookupName()  { return FString(TEXT("BankLookup")); }
     static inline FString AssetLookupName() { return FString(TEXT("AssetLookup")); }
+    static inline FString MapManifestsName() { return FString(TEXT("MapManifests")); }
+    static inline FString CompactLookupName() { return FString(TEXT("CompactLookup")); }
 
 private:
-    FString GetBankPathByGuid(const FGuid& Guid) const;
+    struct FBankPath
+    {
+        /** Path relative to the bank output directory, and the full path built from it */
+        FString Path;
+        FString FullPath;
+        bool bIsMasterBank;
+    };
+
+    void RequestPackage(const FString &PackagePath, const FString &AssetName);
+    void OnPackageLoaded(const FName &PackageName, UPackage *Package, EAsyncLoadingResult::Type Result, FString AssetName);
+    void FinishLoad();
+    void LogLookupLoaded(bool bLoadedLookup, const TCHAR *LookupName);
+    bool IsBankLookupLoaded() const;
+    void BuildBankPathIndex();
+    void BuildEventBankIndex();
+    const FBankPath *FindBankPath(const FGuid& Guid) const;
     FString GetLocalizedBankPath(const UDataTable* BankTable) const;
 
     FString ActiveLocale;
+
+    /** Bank paths for the active locale by bank GUID, rebuilt when the lookup is loaded or the locale changes */
+    TMap<FGuid, FBankPath> BankPathIndex;
+
+    /** Bank GUIDs each event needs, by event GUID. Only built from the DataTables, the compact lookup is queried directly */
+    TMap<FGuid, TArray<FGuid>> EventBankIndex;
+
+    /** Used in place of the lookup DataTables when it has been built, which are then never loaded */
+    UFMODCompactLookup *CompactLookup;
+
     UFMODBankLookup *BankLookup;
     UDataTable *AssetLookup;
+    UDataTable *MapManifests;
+
+    /** Lookup packages still loading, and the requests to flush when a query has to wait for them */
+    int32 PendingPackages;
+    TArray<int32> RequestIds;
+    bool bLoaded;
 };
@@ -4,6 +4,7 @@
 #include "FMODStudioModule.h"
 #include "FMODUtils.h"
 #include "FMODEvent.h"
+#include "FMODEmitterSubsystem.h"
 #include "FMODListener.h"
 #include "FMODSettings.h"
 #include "fmod_studio.hpp"
@@ -40,6 +41,8 @@ UFMODAudioComponent::UFMODAudioComponent(const FObjectInitializer &ObjectInitial
     , OcclusionID()
     , AmbientVolumeID()
     , AmbientLPFID()
+    , StudioDescription(nullptr)
+    , SuppressedParameterUpdates(0)
     , ProgrammerSound(nullptr)
     , NeedDestroyProgrammerSoundCallback(false)
     , EventLength(0)
@@ -85,6 +88,13 @@ void UFMODAudioComponent::OnRegister()
 {
     Super::OnRegister();
 
+    // Starts loading the banks for components spawned after their level was added
+    UWorld *World = GetWorld();
+    if (IsValid(Event) && World && World->IsGameWorld())
+    {
+        GetStudioModule().NotifyLevelEventUsed(GetComponentLevel(), Event->AssetGuid, false);
+    }
+
 #if WITH_EDITORONLY_DATA
     if (!bDefaultParameterValuesCached)
     {
@@ -157,18 +167,44 @@ void UFMODAudioComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransfor
     Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
     if (StudioInstance)
     {
-        FMOD_3D_ATTRIBUTES attr = { { 0 } };
-        attr.position = FMODUtils::ConvertWorldVector(GetComponentTransform().GetLocation());
-        attr.up = FMODUtils::ConvertUnitVector(GetComponentTransform().GetUnitAxis(EAxis::Z));
-        attr.forward = FMODUtils::ConvertUnitVector(GetComponentTransform().GetUnitAxis(EAxis::X));
-        attr.velocity = FMODUtils::ConvertWorldVector(GetOwner()->GetVelocity());
+        MarkEmitterDirty(true);
+    }
+}
 
-        StudioInstance->set3DAttributes(&attr);
+void UFMODAudioComponent::MarkEmitterDirty(bool bTransformChanged)
+{
+    UWorld *World = GetWorld();
+    UFMODEmitterSubsystem *Emitters = World ? World->GetSubsystem<UFMODEmitterSubsystem>() : nullptr;
+    if (Emitters)
+    {
+        Emitters->MarkDirty(this, bTransformChanged);
+        return;
+    }
 
-        UpdateInteriorVolumes();
-        UpdateAttenuation();
-        ApplyVolumeLPF();
+    // Worlds without subsystems, such as animation previews, are updated straight away
+    if (bTransformChanged)
+    {
+        FMOD_3D_ATTRIBUTES attr = { { 0 } };
+        Get3DAttributes(attr);
+        StudioInstance->set3DAttributes(&attr);
     }
+    UpdateEnvironment();
+}
+
+void UFMODAudioComponent::Get3DAttributes(FMOD_3D_ATTRIBUTES &Attributes) const
+{
+    const FTransform &Transform = GetComponentTransform();
+    Attributes.position = FMODUtils::ConvertWorldVector(Transform.GetLocation());
+    Attributes.up = FMODUtils::ConvertUnitVector(Transform.GetUnitAxis(EAxis::Z));
+    Attributes.forward = FMODUtils::ConvertUnitVector(Transform.GetUnitAxis(EAxis::X));
+    Attributes.velocity = FMODUtils::ConvertWorldVector(GetOwner() ? GetOwner()->GetVelocity() : FVector::ZeroVector);
+}
+
+void UFMODAudioComponent::UpdateEnvironment()
+{
+    UpdateInteriorVolumes();
+    UpdateAttenuation();
+    ApplyVolumeLPF();
 }
 
 // Taken mostly from ActiveSound.cpp
@@ -424,9 +460,7 @@ void UFMODAudioComponent::TickComponent(float DeltaTime, enum ELevelTick TickTyp
         {
             if (GetStudioModule().HasListenerMoved())
             {
-                UpdateInteriorVolumes();
-                UpdateAttenuation();
-                ApplyVolumeLPF();
+                MarkEmitterDirty(false);
             }
 
             if (bEnableTimelineCallbacks)
@@ -719,11 +753,23 @@ void UFMODAudioComponent::PlayInternal(EFMODSystemContext::Type Context, bool bR
 
     UE_LOG(LogFMOD, Verbose, TEXT("UFMODAudioComponent %p Play"), this);
 
+    // The event may have changed since the component registered, or its banks may still be loading
+    bool bGameWorld = (Context != EFMODSystemContext::Editor && GetWorld() && GetWorld()->IsGameWorld());
+    if (bGameWorld && IsValid(Event))
+    {
+        GetStudioModule().NotifyLevelEventUsed(GetComponentLevel(), Event->AssetGuid, true);
+    }
+
     // Only play events in PIE/game, not when placing them in the editor
     FMOD::Studio::EventDescription *EventDesc = GetStudioModule().GetEventDescription(Event, Context);
+    if (!EventDesc && bGameWorld && IsValid(Event))
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("UFMODAudioComponent %s can't play %s, the event isn't in any loaded bank"), *GetName(), *Event->GetName());
+    }
     if (EventDesc != nullptr)
     {
         EventDesc->getLength(&EventLength);
+        StudioDescription = EventDesc;
         if (!StudioInstance || !StudioInstance->isValid())
         {
             FMOD_RESULT result = EventDesc->createInstance(&StudioInstance);
@@ -731,6 +777,11 @@ void UFMODAudioComponent::PlayInternal(EFMODSystemContext::Type Context, bool bR
                 return;
         }
 
+        if (Context != EFMODSystemContext::Editor)
+        {
+            GetStudioModule().NotifyEventPlayed(EventDesc);
+        }
+
         const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
         FMOD_STUDIO_PARAMETER_DESCRIPTION paramDesc = {};
         FString param = Settings.OcclusionParameter;
@@ -767,11 +818,18 @@ void UFMODAudioComponent::PlayInternal(EFMODSystemContext::Type Context, bool bR
             }
         }
 
-        OnUpdateTransform(EUpdateTransformFlags::SkipPhysicsUpdate);
+        // Positioned straight away rather than queued, so the event doesn't start at the origin
+        FMOD_3D_ATTRIBUTES attr = { { 0 } };
+        Get3DAttributes(attr);
+        StudioInstance->set3DAttributes(&attr);
+        UpdateEnvironment();
+
         // Set initial parameters
         for (auto Kvp : ParameterCache)
         {
-            FMOD_RESULT Result = StudioInstance->setParameterByName(TCHAR_TO_UTF8(*Kvp.Key.ToString()), Kvp.Value);
+            FMOD_STUDIO_PARAMETER_ID ParameterID;
+            FMOD_RESULT Result = FindParameterID(Kvp.Key, ParameterID) ? StudioInstance->setParameterByID(ParameterID, Kvp.Value)
+                                                                       : FMOD_ERR_EVENT_NOTFOUND;
             if (Result != FMOD_OK)
             {
                 UE_LOG(LogFMOD, Warning, TEXT("Failed to set initial parameter %s"), *Kvp.Key.ToString());
@@ -877,6 +935,7 @@ void UFMODAudioComponent::ReleaseEventInstance()
         StudioInstance->release();
         StudioInstance = nullptr;
     }
+    StudioDescription = nullptr;
 }
 
 void UFMODAudioComponent::KeyOff()
@@ -969,7 +1028,9 @@ void UFMODAudioComponent::SetParameter(FName Name, float Value)
 {
     if (StudioInstance)
     {
-        FMOD_RESULT Result = StudioInstance->setParameterByName(TCHAR_TO_UTF8(*Name.ToString()), Value);
+        FMOD_STUDIO_PARAMETER_ID ParameterID;
+        FMOD_RESULT Result = FindParameterID(Name, ParameterID) ? StudioInstance->setParameterByID(ParameterID, Value)
+                                                                : FMOD_ERR_EVENT_NOTFOUND;
         if (Result != FMOD_OK)
         {
             UE_LOG(LogFMOD, Warning, TEXT("Failed to set parameter %s"), *Name.ToString());
@@ -978,6 +1039,65 @@ void UFMODAudioComponent::SetParameter(FName Name, float Value)
     ParameterCache.FindOrAdd(Name) = Value;
 }
 
+void UFMODAudioComponent::SetParameters(const TArray<FFMODParameterUpdate> &Updates)
+{
+    TArray<FMOD_STUDIO_PARAMETER_ID, TInlineAllocator<16>> IDs;
+    TArray<float, TInlineAllocator<16>> Values;
+
+    for (const FFMODParameterUpdate &Update : Updates)
+    {
+        float *CachedValue = ParameterCache.Find(Update.Name);
+        if (CachedValue && FMath::Abs(Update.Value - *CachedValue) <= Update.Epsilon)
+        {
+            // The cached value is only updated when a value is sent, so slow drift still gets through eventually
+            ++SuppressedParameterUpdates;
+            continue;
+        }
+
+        if (StudioInstance)
+        {
+            FMOD_STUDIO_PARAMETER_ID ParameterID;
+            if (FindParameterID(Update.Name, ParameterID))
+            {
+                IDs.Add(ParameterID);
+                Values.Add(Update.Value);
+            }
+            else
+            {
+                UE_LOG(LogFMOD, Warning, TEXT("Failed to set parameter %s"), *Update.Name.ToString());
+            }
+        }
+
+        if (CachedValue)
+        {
+            *CachedValue = Update.Value;
+        }
+        else
+        {
+            ParameterCache.Add(Update.Name, Update.Value);
+        }
+    }
+
+    if (IDs.Num() > 0)
+    {
+        FMOD_RESULT Result = StudioInstance->setParametersByIDs(IDs.GetData(), Values.GetData(), IDs.Num());
+        if (Result != FMOD_OK)
+        {
+            UE_LOG(LogFMOD, Warning, TEXT("Failed to set %d parameters"), IDs.Num());
+        }
+    }
+}
+
+int32 UFMODAudioComponent::GetSuppressedParameterUpdates() const
+{
+    return SuppressedParameterUpdates;
+}
+
+bool UFMODAudioComponent::FindParameterID(FName Name, FMOD_STUDIO_PARAMETER_ID &ID)
+{
+    return StudioDescription != nullptr && GetStudioModule().GetParameterID(StudioDescription, Name, ID);
+}
+
 void UFMODAudioComponent::SetProperty(EFMODEventProperty::Type Property, float Value)
 {
     verify(Property < EFMODEventProperty::Count);
@@ -1049,7 +1169,9 @@ float UFMODAudioComponent::GetParameter(FName Name)
     float Value = CachedValue ? *CachedValue : 0.0;
     if (StudioInstance)
     {
-        FMOD_RESULT Result = StudioInstance->getParameterByName(TCHAR_TO_UTF8(*Name.ToString()), &Value);
+        FMOD_STUDIO_PARAMETER_ID ParameterID;
+        FMOD_RESULT Result = FindParameterID(Name, ParameterID) ? StudioInstance->getParameterByID(ParameterID, &Value)
+                                                                : FMOD_ERR_EVENT_NOTFOUND;
         if (Result != FMOD_OK)
         {
             UE_LOG(LogFMOD, Warning, TEXT("Failed to get parameter %s"), *Name.ToString());
@@ -1068,7 +1190,9 @@ void UFMODAudioComponent::GetParameterValue(FName Name, float &UserValue, float
     float *CachedValue = ParameterCache.Find(Name);
     if (StudioInstance)
     {
-        FMOD_RESULT Result = StudioInstance->getParameterByName(TCHAR_TO_UTF8(*Name.ToString()), &UserValue, &FinalValue);
+        FMOD_STUDIO_PARAMETER_ID ParameterID;
+        FMOD_RESULT Result = FindParameterID(Name, ParameterID) ? StudioInstance->getParameterByID(ParameterID, &UserValue, &FinalValue)
+                                                                : FMOD_ERR_EVENT_NOTFOUND;
         if (Result != FMOD_OK)
         {
             UserValue = FinalValue = 0;
@@ -3,4 +3,5 @@
 UFMODBankLookup::UFMODBankLookup(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
     , DataTable(nullptr)
+    , EventBanks(nullptr)
 {}
\ No newline at end of file
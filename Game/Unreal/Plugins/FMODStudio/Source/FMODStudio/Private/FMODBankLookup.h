@@ -22,6 +22,15 @@ struct FMODSTUDIO_API FFMODLocalizedBankTable : public FTableRowBase
     UDataTable *Banks = nullptr;
 };
 
+USTRUCT()
+struct FMODSTUDIO_API FFMODEventBanksRow : public FTableRowBase
+{
+    GENERATED_BODY()
+    /** GUIDs of the banks an event needs, including the sample data and stream banks built alongside them */
+    UPROPERTY(VisibleAnywhere, Category="FMOD|Internal|BankLookup")
+    TArray<FGuid> Banks;
+};
+
 UCLASS()
 class FMODSTUDIO_API UFMODBankLookup : public UObject
 {
@@ -31,6 +40,10 @@ public:
     UPROPERTY(VisibleAnywhere, Category="FMOD|Internal|BankLookup")
     UDataTable *DataTable;
 
+    /** Rows of FFMODEventBanksRow keyed by event GUID */
+    UPROPERTY(VisibleAnywhere, Category="FMOD|Internal|BankLookup")
+    UDataTable *EventBanks;
+
     UPROPERTY(VisibleAnywhere, Category="FMOD|Internal|BankLookup")
     FString MasterBankPath;
 
@@ -0,0 +1,265 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODBankResidency.h"
+#include "FMODSampleDataBudget.h"
+#include "FMODSettings.h"
+#include "fmod_studio.hpp"
+#include "fmod_errors.h"
+#include "FMODStudioPrivatePCH.h"
+
+FFMODBankResidency::FFMODBankResidency(IFMODStudioModule &InModule, FFMODSampleDataBudget &InSampleDataBudget)
+    : Module(InModule)
+    , SampleDataBudget(InSampleDataBudget)
+{
+}
+
+FMOD::Studio::Bank *FFMODBankResidency::AcquireBank(const FString &Path, bool bBlocking, EFMODBankOwner::Type Owner)
+{
+    FEntry *Entry = Acquire(ResolvePath(Path), bBlocking);
+    if (!Entry)
+    {
+        return nullptr;
+    }
+
+    ++Entry->MetadataRefs;
+    ++Entry->OwnerMetadataRefs[Owner];
+    return Entry->Bank;
+}
+
+bool FFMODBankResidency::ReleaseBank(const FString &InPath, EFMODBankOwner::Type Owner)
+{
+    const FString &Path = ResolvePath(InPath);
+    FEntry *Entry = Entries.Find(Path);
+    if (!Entry || Entry->OwnerMetadataRefs[Owner] == 0)
+    {
+        return false;
+    }
+
+    --Entry->MetadataRefs;
+    --Entry->OwnerMetadataRefs[Owner];
+    Release(Path, *Entry);
+    return true;
+}
+
+FMOD::Studio::Bank *FFMODBankResidency::AcquireSampleData(const FString &InPath, bool bBlocking, EFMODBankOwner::Type Owner)
+{
+    const FString &Path = ResolvePath(InPath);
+    FEntry *Entry = Acquire(Path, bBlocking);
+    if (!Entry)
+    {
+        return nullptr;
+    }
+
+    ++Entry->OwnerSampleDataRefs[Owner];
+    if (++Entry->SampleDataRefs == 1)
+    {
+        Entry->SampleDataUnloadTime = 0.0;
+        UpdateSampleData(Path, *Entry);
+    }
+    return Entry->Bank;
+}
+
+bool FFMODBankResidency::ReleaseSampleData(const FString &InPath, EFMODBankOwner::Type Owner)
+{
+    const FString &Path = ResolvePath(InPath);
+    FEntry *Entry = Entries.Find(Path);
+    if (!Entry || Entry->OwnerSampleDataRefs[Owner] == 0)
+    {
+        return false;
+    }
+
+    --Entry->OwnerSampleDataRefs[Owner];
+    if (--Entry->SampleDataRefs == 0)
+    {
+        Entry->SampleDataUnloadTime = FPlatformTime::Seconds() + GetDefault<UFMODSettings>()->BankUnloadLingerTime;
+    }
+    Release(Path, *Entry);
+    return true;
+}
+
+bool FFMODBankResidency::IsAcquired(const FString &Path) const
+{
+    const FEntry *Entry = Entries.Find(ResolvePath(Path));
+    return Entry && Entry->IsReferenced();
+}
+
+bool FFMODBankResidency::SwapBank(const FString &OldPath, const FString &NewPath, FMOD::Studio::Bank *NewBank)
+{
+    FEntry Entry;
+    bool bFound = Entries.RemoveAndCopyValue(OldPath, Entry);
+
+    // The new path may have been acquired while the old bank was still loaded, sharing its handle
+    FEntry NewEntry;
+    if (Entries.RemoveAndCopyValue(NewPath, NewEntry))
+    {
+        Entry.MetadataRefs += NewEntry.MetadataRefs;
+        Entry.SampleDataRefs += NewEntry.SampleDataRefs;
+        for (int32 i = 0; i < EFMODBankOwner::Max; ++i)
+        {
+            Entry.OwnerMetadataRefs[i] += NewEntry.OwnerMetadataRefs[i];
+            Entry.OwnerSampleDataRefs[i] += NewEntry.OwnerSampleDataRefs[i];
+        }
+        Entry.bOwnsBank |= NewEntry.bOwnsBank;
+        bFound = true;
+    }
+
+    for (TPair<FString, FString> &Redirect : Redirects)
+    {
+        if (Redirect.Value == OldPath)
+        {
+            Redirect.Value = NewPath;
+        }
+    }
+    Redirects.Remove(NewPath);
+    Redirects.Add(OldPath, NewPath);
+
+    if (!bFound || !NewBank)
+    {
+        return false;
+    }
+
+    Entry.Bank = NewBank;
+    Entry.bSampleDataLoaded = false;
+    Entry.SampleDataUnloadTime = 0.0;
+
+    bool bReloadSampleData = Entry.SampleDataRefs > 0;
+    Entries.Add(NewPath, Entry);
+    return bReloadSampleData;
+}
+
+void FFMODBankResidency::Tick()
+{
+    double Now = FPlatformTime::Seconds();
+
+    for (auto It = Entries.CreateIterator(); It; ++It)
+    {
+        FEntry &Entry = It.Value();
+
+        if (Entry.SampleDataRefs > 0)
+        {
+            UpdateSampleData(It.Key(), Entry);
+        }
+        else if (Entry.SampleDataUnloadTime > 0.0 && Entry.SampleDataUnloadTime <= Now)
+        {
+            UnloadSampleData(It.Key(), Entry);
+        }
+
+        if (!Entry.IsReferenced() && Entry.BankUnloadTime <= Now)
+        {
+            UnloadBank(It.Key(), Entry);
+            It.RemoveCurrent();
+        }
+    }
+}
+
+void FFMODBankResidency::Reset()
+{
+    for (TPair<FString, FEntry> &Pair : Entries)
+    {
+        if (Pair.Value.IsReferenced())
+        {
+            UE_LOG(LogFMOD, Verbose, TEXT("Unloading bank %s with %d metadata and %d sample data references"), *Pair.Key,
+                Pair.Value.MetadataRefs, Pair.Value.SampleDataRefs);
+        }
+        UnloadBank(Pair.Key, Pair.Value);
+    }
+    Entries.Reset();
+    Redirects.Reset();
+}
+
+const FString &FFMODBankResidency::ResolvePath(const FString &Path) const
+{
+    const FString *Redirect = Redirects.Find(Path);
+    return Redirect ? *Redirect : Path;
+}
+
+FFMODBankResidency::FEntry *FFMODBankResidency::Acquire(const FString &Path, bool bBlocking)
+{
+    if (FEntry *Entry = Entries.Find(Path))
+    {
+        // Still resident, possibly lingering after its last release
+        Entry->BankUnloadTime = 0.0;
+        return Entry;
+    }
+
+    if (!Module.GetStudioSystem(EFMODSystemContext::Runtime))
+    {
+        return nullptr;
+    }
+
+    FMOD::Studio::Bank *Bank = nullptr;
+    FMOD_STUDIO_LOAD_BANK_FLAGS Flags = bBlocking ? FMOD_STUDIO_LOAD_BANK_NORMAL : FMOD_STUDIO_LOAD_BANK_NONBLOCKING;
+    FMOD_RESULT Result = Module.LoadBankFile(EFMODSystemContext::Runtime, Path, Flags, &Bank);
+
+    // Banks loaded at startup are shared rather than loaded twice
+    bool bLoadedElsewhere = (Result == FMOD_ERR_EVENT_ALREADY_LOADED && Bank != nullptr);
+    if ((Result != FMOD_OK && !bLoadedElsewhere) || !Bank)
+    {
+        UE_LOG(LogFMOD, Error, TEXT("Failed to load bank %s: %s"), *Path, UTF8_TO_TCHAR(FMOD_ErrorString(Result)));
+        return nullptr;
+    }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Bank %s is now resident%s"), *Path, bLoadedElsewhere ? TEXT(" (already loaded)") : TEXT(""));
+
+    FEntry &Entry = Entries.Add(Path);
+    Entry.Bank = Bank;
+    Entry.bOwnsBank = !bLoadedElsewhere;
+    return &Entry;
+}
+
+void FFMODBankResidency::Release(const FString &Path, FEntry &Entry)
+{
+    if (Entry.IsReferenced())
+    {
+        return;
+    }
+
+    float LingerTime = GetDefault<UFMODSettings>()->BankUnloadLingerTime;
+    if (LingerTime <= 0.0f)
+    {
+        UnloadBank(Path, Entry);
+        Entries.Remove(Path);
+        return;
+    }
+
+    Entry.BankUnloadTime = FPlatformTime::Seconds() + LingerTime;
+}
+
+void FFMODBankResidency::UpdateSampleData(const FString &Path, FEntry &Entry)
+{
+    if (Entry.bSampleDataLoaded)
+    {
+        return;
+    }
+
+    // Sample data can only be requested once a non-blocking load has finished
+    FMOD_STUDIO_LOADING_STATE BankState = FMOD_STUDIO_LOADING_STATE_ERROR;
+    if (Entry.Bank->getLoadingState(&BankState) != FMOD_OK || BankState != FMOD_STUDIO_LOADING_STATE_LOADED)
+    {
+        return;
+    }
+
+    SampleDataBudget.LoadBank(Path, Entry.Bank);
+    Entry.bSampleDataLoaded = true;
+}
+
+void FFMODBankResidency::UnloadSampleData(const FString &Path, FEntry &Entry)
+{
+    if (Entry.bSampleDataLoaded)
+    {
+        SampleDataBudget.UnloadBank(Path);
+    }
+    Entry.bSampleDataLoaded = false;
+    Entry.SampleDataUnloadTime = 0.0;
+}
+
+void FFMODBankResidency::UnloadBank(const FString &Path, FEntry &Entry)
+{
+    UnloadSampleData(Path, Entry);
+
+    if (Entry.bOwnsBank)
+    {
+        UE_LOG(LogFMOD, Verbose, TEXT("Unloading bank %s"), *Path);
+        Module.UnloadBank(EFMODSystemContext::Runtime, Entry.Bank);
+    }
+}
@@ -0,0 +1,91 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FMODStudioModule.h"
+
+class FFMODSampleDataBudget;
+
+/**
+ * Reference counted residency for runtime banks and their sample data.
+ * A bank stays loaded while it has any metadata or sample data references, and its sample data stays loaded while it
+ * has sample data references. Once the last reference goes the unload is deferred by the configured linger time, so
+ * banks released and acquired again in quick succession are not reloaded from disk. References are counted per owner,
+ * and an owner can only release references it took itself.
+ */
+class FFMODBankResidency
+{
+public:
+    FFMODBankResidency(IFMODStudioModule &InModule, FFMODSampleDataBudget &InSampleDataBudget);
+
+    FMOD::Studio::Bank *AcquireBank(const FString &Path, bool bBlocking, EFMODBankOwner::Type Owner);
+    bool ReleaseBank(const FString &Path, EFMODBankOwner::Type Owner);
+
+    FMOD::Studio::Bank *AcquireSampleData(const FString &Path, bool bBlocking, EFMODBankOwner::Type Owner);
+    bool ReleaseSampleData(const FString &Path, EFMODBankOwner::Type Owner);
+
+    bool IsAcquired(const FString &Path) const;
+
+    /**
+     * Move the references held on a bank to the bank replacing it, once the old bank has been unloaded. References
+     * later released or acquired through the old path go to the new one. Returns true if sample data is referenced,
+     * in which case it is loaded again here once the new bank has loaded. A null bank drops the entry.
+     */
+    bool SwapBank(const FString &OldPath, const FString &NewPath, FMOD::Studio::Bank *NewBank);
+
+    /** Load sample data for banks that have finished loading, and unload anything whose linger time has passed */
+    void Tick();
+
+    /** Unload everything immediately, called before the runtime system is destroyed */
+    void Reset();
+
+private:
+    struct FEntry
+    {
+        FEntry()
+            : Bank(nullptr)
+            , MetadataRefs(0)
+            , SampleDataRefs(0)
+            , bOwnsBank(false)
+            , bSampleDataLoaded(false)
+            , BankUnloadTime(0.0)
+            , SampleDataUnloadTime(0.0)
+        {
+            FMemory::Memzero(OwnerMetadataRefs);
+            FMemory::Memzero(OwnerSampleDataRefs);
+        }
+
+        bool IsReferenced() const { return MetadataRefs > 0 || SampleDataRefs > 0; }
+
+        FMOD::Studio::Bank *Bank;
+        int32 MetadataRefs;
+        int32 SampleDataRefs;
+
+        /** The totals above split by owner */
+        int32 OwnerMetadataRefs[EFMODBankOwner::Max];
+        int32 OwnerSampleDataRefs[EFMODBankOwner::Max];
+
+        /** False if the bank was already loaded elsewhere, in which case it is never unloaded here */
+        bool bOwnsBank;
+        bool bSampleDataLoaded;
+
+        /** Time at which an unreferenced bank or its sample data is unloaded, zero if not pending */
+        double BankUnloadTime;
+        double SampleDataUnloadTime;
+    };
+
+    const FString &ResolvePath(const FString &Path) const;
+    FEntry *Acquire(const FString &Path, bool bBlocking);
+    void Release(const FString &Path, FEntry &Entry);
+    void UpdateSampleData(const FString &Path, FEntry &Entry);
+    void UnloadSampleData(const FString &Path, FEntry &Entry);
+    void UnloadBank(const FString &Path, FEntry &Entry);
+
+    IFMODStudioModule &Module;
+    FFMODSampleDataBudget &SampleDataBudget;
+    TMap<FString, FEntry> Entries;
+
+    /** Paths of swapped banks, mapped to the path of the bank that replaced them */
+    TMap<FString, FString> Redirects;
+};
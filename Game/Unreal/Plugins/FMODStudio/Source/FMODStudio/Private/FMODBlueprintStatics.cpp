@@ -9,10 +9,80 @@
 #include "FMODEvent.h"
 #include "FMODBus.h"
 #include "FMODVCA.h"
+#include "Engine/Engine.h"
+#include "LatentActions.h"
 #include "fmod_studio.hpp"
 #include "fmod_errors.h"
 #include "FMODStudioPrivatePCH.h"
 
+/////////////////////////////////////////////////////
+// FFMODFindAssetAction
+
+/** Waits for an asynchronous asset lookup, then writes the asset found to the node's output */
+template <typename AssetType>
+class FFMODFindAssetAction : public FPendingLatentAction
+{
+public:
+    FFMODFindAssetAction(const FString &Name, AssetType *&InResult, const FLatentActionInfo &LatentInfo)
+        : Result(InResult)
+        , State(MakeShared<FState>())
+        , ExecutionFunction(LatentInfo.ExecutionFunction)
+        , OutputLink(LatentInfo.Linkage)
+        , CallbackTarget(LatentInfo.CallbackTarget)
+    {
+        // The callback holds the state rather than the action, which may be destroyed before it is called
+        TSharedRef<FState> CallbackState = State;
+        IFMODStudioModule::Get().FindAssetByNameAsync(Name, FFMODAssetFound::CreateLambda([CallbackState](UFMODAsset *Asset) {
+            CallbackState->Asset = Asset;
+            CallbackState->bDone = true;
+        }));
+    }
+
+    virtual void UpdateOperation(FLatentResponse &Response) override
+    {
+        if (State->bDone)
+        {
+            Result = Cast<AssetType>(State->Asset.Get());
+        }
+        Response.FinishAndTriggerIf(State->bDone, ExecutionFunction, OutputLink, CallbackTarget);
+    }
+
+private:
+    struct FState
+    {
+        FState()
+            : bDone(false)
+        {
+        }
+
+        TWeakObjectPtr<UFMODAsset> Asset;
+        bool bDone;
+    };
+
+    AssetType *&Result;
+    TSharedRef<FState> State;
+    FName ExecutionFunction;
+    int32 OutputLink;
+    FWeakObjectPtr CallbackTarget;
+};
+
+template <typename AssetType>
+static void FindByNameAsync(UObject *WorldContextObject, const FString &Name, AssetType *&Result, const FLatentActionInfo &LatentInfo)
+{
+    UWorld *World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    if (!World)
+    {
+        return;
+    }
+
+    FLatentActionManager &LatentActionManager = World->GetLatentActionManager();
+    if (!LatentActionManager.FindExistingAction<FFMODFindAssetAction<AssetType>>(LatentInfo.CallbackTarget, LatentInfo.UUID))
+    {
+        Result = nullptr;
+        LatentActionManager.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID, new FFMODFindAssetAction<AssetType>(Name, Result, LatentInfo));
+    }
+}
+
 /////////////////////////////////////////////////////
 // UFMODBlueprintStatics
 
@@ -42,6 +112,8 @@ FFMODEventInstance UFMODBlueprintStatics::PlayEventAtLocation(
             EventDesc->createInstance(&EventInst);
             if (EventInst != nullptr)
             {
+                IFMODStudioModule::Get().NotifyEventPlayed(EventDesc);
+
                 FMOD_3D_ATTRIBUTES EventAttr = { { 0 } };
                 FMODUtils::Assign(EventAttr, Location);
                 EventInst->set3DAttributes(&EventAttr);
@@ -132,6 +204,16 @@ UFMODEvent *UFMODBlueprintStatics::FindEventByName(const FString &Name)
     return IFMODStudioModule::Get().FindEventByName(Name);
 }
 
+void UFMODBlueprintStatics::FindAssetByNameAsync(UObject *WorldContextObject, const FString &Name, UFMODAsset *&Asset, FLatentActionInfo LatentInfo)
+{
+    FindByNameAsync(WorldContextObject, Name, Asset, LatentInfo);
+}
+
+void UFMODBlueprintStatics::FindEventByNameAsync(UObject *WorldContextObject, const FString &Name, UFMODEvent *&Event, FLatentActionInfo LatentInfo)
+{
+    FindByNameAsync(WorldContextObject, Name, Event, LatentInfo);
+}
+
 void UFMODBlueprintStatics::LoadBank(class UFMODBank *Bank, bool bBlocking, bool bLoadSampleData)
 {
     FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
@@ -139,18 +221,11 @@ void UFMODBlueprintStatics::LoadBank(class UFMODBank *Bank, bool bBlocking, bool
     {
         UE_LOG(LogFMOD, Log, TEXT("LoadBank %s"), *Bank->GetName());
 
+        // UnloadBank releases both references, so sample data loaded here doesn't outlive the bank reference
         FString BankPath = IFMODStudioModule::Get().GetBankPath(*Bank);
-        FMOD::Studio::Bank *bank = nullptr;
-        FMOD_STUDIO_LOAD_BANK_FLAGS flags = (bBlocking || bLoadSampleData) ? FMOD_STUDIO_LOAD_BANK_NORMAL : FMOD_STUDIO_LOAD_BANK_NONBLOCKING;
-
-        FMOD_RESULT result = StudioSystem->loadBankFile(TCHAR_TO_UTF8(*BankPath), flags, &bank);
-        if (result != FMOD_OK)
+        if (IFMODStudioModule::Get().AcquireBank(BankPath, bBlocking || bLoadSampleData, EFMODBankOwner::BlueprintBank) && bLoadSampleData)
         {
-            UE_LOG(LogFMOD, Error, TEXT("Failed to load bank %s: %s"), *Bank->GetName(), UTF8_TO_TCHAR(FMOD_ErrorString(result)));
-        }
-        if (result == FMOD_OK && bLoadSampleData)
-        {
-            bank->loadSampleData();
+            IFMODStudioModule::Get().AcquireBankSampleData(BankPath, true, EFMODBankOwner::BlueprintBank);
         }
     }
 }
@@ -162,14 +237,72 @@ void UFMODBlueprintStatics::UnloadBank(class UFMODBank *Bank)
     {
         UE_LOG(LogFMOD, Log, TEXT("UnloadBank %s"), *Bank->GetName());
 
+        FString BankPath = IFMODStudioModule::Get().GetBankPath(*Bank);
+        if (IFMODStudioModule::Get().ReleaseBank(BankPath, EFMODBankOwner::BlueprintBank))
+        {
+            IFMODStudioModule::Get().ReleaseBankSampleData(BankPath, EFMODBankOwner::BlueprintBank);
+            return;
+        }
+
+        // References taken by per-level loading or other native callers are left alone
+        if (IFMODStudioModule::Get().IsBankAcquired(BankPath))
+        {
+            UE_LOG(LogFMOD, Warning, TEXT("UnloadBank %s has no matching LoadBank, leaving the bank loaded for its other users"), *Bank->GetName());
+            return;
+        }
+
+        // Not loaded through LoadBank, so unload it directly
         FMOD::Studio::ID guid = FMODUtils::ConvertGuid(Bank->AssetGuid);
         FMOD::Studio::Bank *bank = nullptr;
         FMOD_RESULT result = StudioSystem->getBankByID(&guid, &bank);
         if (result == FMOD_OK && bank != nullptr)
         {
-            bank->unload();
+            IFMODStudioModule::Get().UnloadBank(EFMODSystemContext::Runtime, bank);
+        }
+    }
+}
+
+static TArray<FGuid> GetEventGuids(const TArray<UFMODEvent *> &Events)
+{
+    TArray<FGuid> Guids;
+    for (const UFMODEvent *Event : Events)
+    {
+        if (IsValid(Event))
+        {
+            Guids.AddUnique(Event->AssetGuid);
         }
     }
+    return Guids;
+}
+
+void UFMODBlueprintStatics::LoadBanksForEvents(const TArray<UFMODEvent *> &Events, bool bBlocking)
+{
+    IFMODStudioModule::Get().LoadBanksForEvents(GetEventGuids(Events), bBlocking);
+}
+
+void UFMODBlueprintStatics::UnloadBanksForEvents(const TArray<UFMODEvent *> &Events)
+{
+    IFMODStudioModule::Get().UnloadBanksForEvents(GetEventGuids(Events));
+}
+
+bool UFMODBlueprintStatics::AreBanksLoaded()
+{
+    return IFMODStudioModule::Get().AreBanksLoaded();
+}
+
+float UFMODBlueprintStatics::GetBankLoadProgress()
+{
+    return IFMODStudioModule::Get().GetBankLoadProgress();
+}
+
+bool UFMODBlueprintStatics::IsMapAudioWarmedUp()
+{
+    return IFMODStudioModule::Get().IsMapAudioWarmedUp();
+}
+
+float UFMODBlueprintStatics::GetMapAudioWarmupProgress()
+{
+    return IFMODStudioModule::Get().GetMapAudioWarmupProgress();
 }
 
 bool UFMODBlueprintStatics::IsBankLoaded(class UFMODBank *Bank)
@@ -197,12 +330,13 @@ void UFMODBlueprintStatics::LoadBankSampleData(class UFMODBank *Bank)
     FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
     if (StudioSystem != nullptr && IsValid(Bank))
     {
+        // As before reference counting, this only applies to a bank that is already loaded
         FMOD::Studio::ID guid = FMODUtils::ConvertGuid(Bank->AssetGuid);
         FMOD::Studio::Bank *bank = nullptr;
         FMOD_RESULT result = StudioSystem->getBankByID(&guid, &bank);
         if (result == FMOD_OK && bank != nullptr)
         {
-            bank->loadSampleData();
+            IFMODStudioModule::Get().AcquireBankSampleData(IFMODStudioModule::Get().GetBankPath(*Bank), false, EFMODBankOwner::BlueprintSampleData);
         }
     }
 }
@@ -212,6 +346,19 @@ void UFMODBlueprintStatics::UnloadBankSampleData(class UFMODBank *Bank)
     FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
     if (StudioSystem != nullptr && IsValid(Bank))
     {
+        FString BankPath = IFMODStudioModule::Get().GetBankPath(*Bank);
+        if (IFMODStudioModule::Get().ReleaseBankSampleData(BankPath, EFMODBankOwner::BlueprintSampleData))
+        {
+            return;
+        }
+
+        if (IFMODStudioModule::Get().IsBankAcquired(BankPath))
+        {
+            UE_LOG(LogFMOD, Warning, TEXT("UnloadBankSampleData %s has no matching LoadBankSampleData, leaving the sample data loaded for its other users"),
+                *Bank->GetName());
+            return;
+        }
+
         FMOD::Studio::ID guid = FMODUtils::ConvertGuid(Bank->AssetGuid);
         FMOD::Studio::Bank *bank = nullptr;
         FMOD_RESULT result = StudioSystem->getBankByID(&guid, &bank);
@@ -226,11 +373,7 @@ void UFMODBlueprintStatics::LoadEventSampleData(UObject *WorldContextObject, cla
 {
     if (IsValid(Event))
     {
-        FMOD::Studio::EventDescription *EventDesc = IFMODStudioModule::Get().GetEventDescription(Event);
-        if (EventDesc != nullptr)
-        {
-            EventDesc->loadSampleData();
-        }
+        IFMODStudioModule::Get().LoadEventSampleData(Event->AssetGuid);
     }
 }
 
@@ -238,11 +381,7 @@ void UFMODBlueprintStatics::UnloadEventSampleData(UObject *WorldContextObject, c
 {
     if (IsValid(Event))
     {
-        FMOD::Studio::EventDescription *EventDesc = IFMODStudioModule::Get().GetEventDescription(Event);
-        if (EventDesc != nullptr)
-        {
-            EventDesc->unloadSampleData();
-        }
+        IFMODStudioModule::Get().UnloadEventSampleData(Event->AssetGuid);
     }
 }
 
@@ -275,85 +414,86 @@ TArray<FFMODEventInstance> UFMODBlueprintStatics::FindEventInstances(UObject *Wo
 
 void UFMODBlueprintStatics::BusSetVolume(class UFMODBus *Bus, float Volume)
 {
-    FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
-    if (StudioSystem != nullptr && IsValid(Bus))
+    BusSetVolume(IFMODStudioModule::Get().GetBus(Bus, EFMODSystemContext::Runtime), Volume);
+}
+
+void UFMODBlueprintStatics::BusSetVolume(FMOD::Studio::Bus *Bus, float Volume)
+{
+    if (Bus != nullptr)
     {
-        FMOD::Studio::ID guid = FMODUtils::ConvertGuid(Bus->AssetGuid);
-        FMOD::Studio::Bus *bus = nullptr;
-        FMOD_RESULT result = StudioSystem->getBusByID(&guid, &bus);
-        if (result == FMOD_OK && bus != nullptr)
-        {
-            bus->setVolume(Volume);
-        }
+        Bus->setVolume(Volume);
     }
 }
 
 void UFMODBlueprintStatics::BusSetPaused(class UFMODBus *Bus, bool bPaused)
 {
-    FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
-    if (StudioSystem != nullptr && IsValid(Bus))
+    BusSetPaused(IFMODStudioModule::Get().GetBus(Bus, EFMODSystemContext::Runtime), bPaused);
+}
+
+void UFMODBlueprintStatics::BusSetPaused(FMOD::Studio::Bus *Bus, bool bPaused)
+{
+    if (Bus != nullptr)
     {
-        FMOD::Studio::ID guid = FMODUtils::ConvertGuid(Bus->AssetGuid);
-        FMOD::Studio::Bus *bus = nullptr;
-        FMOD_RESULT result = StudioSystem->getBusByID(&guid, &bus);
-        if (result == FMOD_OK && bus != nullptr)
-        {
-            bus->setPaused(bPaused);
-        }
+        Bus->setPaused(bPaused);
     }
 }
 
 void UFMODBlueprintStatics::BusSetMute(class UFMODBus *Bus, bool bMute)
 {
-    FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
-    if (StudioSystem != nullptr && IsValid(Bus))
+    BusSetMute(IFMODStudioModule::Get().GetBus(Bus, EFMODSystemContext::Runtime), bMute);
+}
+
+void UFMODBlueprintStatics::BusSetMute(FMOD::Studio::Bus *Bus, bool bMute)
+{
+    if (Bus != nullptr)
     {
-        FMOD::Studio::ID guid = FMODUtils::ConvertGuid(Bus->AssetGuid);
-        FMOD::Studio::Bus *bus = nullptr;
-        FMOD_RESULT result = StudioSystem->getBusByID(&guid, &bus);
-        if (result == FMOD_OK && bus != nullptr)
-        {
-            bus->setMute(bMute);
-        }
+        Bus->setMute(bMute);
     }
 }
 
 void UFMODBlueprintStatics::BusStopAllEvents(UFMODBus *Bus, EFMOD_STUDIO_STOP_MODE stopMode)
 {
-    FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
-    if (StudioSystem != nullptr && IsValid(Bus))
+    BusStopAllEvents(IFMODStudioModule::Get().GetBus(Bus, EFMODSystemContext::Runtime), stopMode);
+}
+
+void UFMODBlueprintStatics::BusStopAllEvents(FMOD::Studio::Bus *Bus, EFMOD_STUDIO_STOP_MODE stopMode)
+{
+    if (Bus != nullptr)
     {
-        FMOD::Studio::ID guid = FMODUtils::ConvertGuid(Bus->AssetGuid);
-        FMOD::Studio::Bus *bus = nullptr;
-        FMOD_RESULT result = StudioSystem->getBusByID(&guid, &bus);
-        if (result == FMOD_OK && bus != nullptr)
-        {
-            bus->stopAllEvents((FMOD_STUDIO_STOP_MODE)stopMode);
-        }
+        Bus->stopAllEvents((FMOD_STUDIO_STOP_MODE)stopMode);
     }
 }
 
 void UFMODBlueprintStatics::VCASetVolume(class UFMODVCA *Vca, float Volume)
 {
-    FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
-    if (StudioSystem != nullptr && IsValid(Vca))
+    VCASetVolume(IFMODStudioModule::Get().GetVCA(Vca, EFMODSystemContext::Runtime), Volume);
+}
+
+void UFMODBlueprintStatics::VCASetVolume(FMOD::Studio::VCA *Vca, float Volume)
+{
+    if (Vca != nullptr)
     {
-        FMOD::Studio::ID guid = FMODUtils::ConvertGuid(Vca->AssetGuid);
-        FMOD::Studio::VCA *vca = nullptr;
-        FMOD_RESULT result = StudioSystem->getVCAByID(&guid, &vca);
-        if (result == FMOD_OK && vca != nullptr)
-        {
-            vca->setVolume(Volume);
-        }
+        Vca->setVolume(Volume);
     }
 }
 
+/** Look up a parameter ID for an instance through the module's cache, rather than by name on every call */
+static bool FindInstanceParameterID(FMOD::Studio::EventInstance *Instance, FName Name, FMOD_STUDIO_PARAMETER_ID &ID)
+{
+    FMOD::Studio::EventDescription *EventDesc = nullptr;
+    return Instance->getDescription(&EventDesc) == FMOD_OK && IFMODStudioModule::Get().GetParameterID(EventDesc, Name, ID);
+}
+
 void UFMODBlueprintStatics::SetGlobalParameterByName(FName Name, float Value)
 {
-    FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
+    IFMODStudioModule &Module = IFMODStudioModule::Get();
+    FMOD::Studio::System *StudioSystem = Module.GetStudioSystem(EFMODSystemContext::Runtime);
     if (StudioSystem != nullptr)
     {
-        FMOD_RESULT Result = StudioSystem->setParameterByName(TCHAR_TO_UTF8(*Name.ToString()), Value);
+        FMOD_STUDIO_PARAMETER_ID ParameterID;
+        FMOD_RESULT Result = Module.GetGlobalParameterID(Name, ParameterID, EFMODSystemContext::Runtime)
+                                 ? StudioSystem->setParameterByID(ParameterID, Value)
+                                 : FMOD_ERR_EVENT_NOTFOUND;
         if (Result != FMOD_OK)
         {
             UE_LOG(LogFMOD, Warning, TEXT("Failed to set parameter %s"), *Name.ToString());
@@ -363,11 +503,15 @@ void UFMODBlueprintStatics::SetGlobalParameterByName(FName Name, float Value)
 
 float UFMODBlueprintStatics::GetGlobalParameterByName(FName Name)
 {
-    FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
+    IFMODStudioModule &Module = IFMODStudioModule::Get();
+    FMOD::Studio::System *StudioSystem = Module.GetStudioSystem(EFMODSystemContext::Runtime);
     float Value = 0.0f;
     if (StudioSystem != nullptr)
     {
-        FMOD_RESULT Result = StudioSystem->getParameterByName(TCHAR_TO_UTF8(*Name.ToString()), &Value);
+        FMOD_STUDIO_PARAMETER_ID ParameterID;
+        FMOD_RESULT Result = Module.GetGlobalParameterID(Name, ParameterID, EFMODSystemContext::Runtime)
+                                 ? StudioSystem->getParameterByID(ParameterID, &Value)
+                                 : FMOD_ERR_EVENT_NOTFOUND;
         if (Result != FMOD_OK)
         {
             UE_LOG(LogFMOD, Warning, TEXT("Failed to get event instance parameter %s"), *Name.ToString());
@@ -378,10 +522,14 @@ float UFMODBlueprintStatics::GetGlobalParameterByName(FName Name)
 
 void UFMODBlueprintStatics::GetGlobalParameterValueByName(FName Name, float &UserValue, float &FinalValue)
 {
-    FMOD::Studio::System *StudioSystem = IFMODStudioModule::Get().GetStudioSystem(EFMODSystemContext::Runtime);
+    IFMODStudioModule &Module = IFMODStudioModule::Get();
+    FMOD::Studio::System *StudioSystem = Module.GetStudioSystem(EFMODSystemContext::Runtime);
     if (StudioSystem != nullptr)
     {
-        FMOD_RESULT Result = StudioSystem->getParameterByName(TCHAR_TO_UTF8(*Name.ToString()), &UserValue, &FinalValue);
+        FMOD_STUDIO_PARAMETER_ID ParameterID;
+        FMOD_RESULT Result = Module.GetGlobalParameterID(Name, ParameterID, EFMODSystemContext::Runtime)
+                                 ? StudioSystem->getParameterByID(ParameterID, &UserValue, &FinalValue)
+                                 : FMOD_ERR_EVENT_NOTFOUND;
         if (Result != FMOD_OK)
         {
             UserValue = FinalValue = 0.0f;
@@ -439,7 +587,10 @@ void UFMODBlueprintStatics::EventInstanceSetParameter(FFMODEventInstance EventIn
 {
     if (EventInstance.Instance)
     {
-        FMOD_RESULT Result = EventInstance.Instance->setParameterByName(TCHAR_TO_UTF8(*Name.ToString()), Value);
+        FMOD_STUDIO_PARAMETER_ID ParameterID;
+        FMOD_RESULT Result = FindInstanceParameterID(EventInstance.Instance, Name, ParameterID)
+                                 ? EventInstance.Instance->setParameterByID(ParameterID, Value)
+                                 : FMOD_ERR_EVENT_NOTFOUND;
         if (Result != FMOD_OK)
         {
             UE_LOG(LogFMOD, Warning, TEXT("Failed to set event instance parameter %s"), *Name.ToString());
@@ -452,7 +603,10 @@ float UFMODBlueprintStatics::EventInstanceGetParameter(FFMODEventInstance EventI
     float Value = 0.0f;
     if (EventInstance.Instance)
     {
-        FMOD_RESULT Result = EventInstance.Instance->getParameterByName(TCHAR_TO_UTF8(*Name.ToString()), &Value);
+        FMOD_STUDIO_PARAMETER_ID ParameterID;
+        FMOD_RESULT Result = FindInstanceParameterID(EventInstance.Instance, Name, ParameterID)
+                                 ? EventInstance.Instance->getParameterByID(ParameterID, &Value)
+                                 : FMOD_ERR_EVENT_NOTFOUND;
         if (Result != FMOD_OK)
         {
             UE_LOG(LogFMOD, Warning, TEXT("Failed to get event instance parameter %s"), *Name.ToString());
@@ -465,7 +619,10 @@ void UFMODBlueprintStatics::EventInstanceGetParameterValue(FFMODEventInstance Ev
 {
     if (EventInstance.Instance)
     {
-        FMOD_RESULT Result = EventInstance.Instance->getParameterByName(TCHAR_TO_UTF8(*Name.ToString()), &UserValue, &FinalValue);
+        FMOD_STUDIO_PARAMETER_ID ParameterID;
+        FMOD_RESULT Result = FindInstanceParameterID(EventInstance.Instance, Name, ParameterID)
+                                 ? EventInstance.Instance->getParameterByID(ParameterID, &UserValue, &FinalValue)
+                                 : FMOD_ERR_EVENT_NOTFOUND;
         if (Result != FMOD_OK)
         {
             UserValue = FinalValue = 0.0f;
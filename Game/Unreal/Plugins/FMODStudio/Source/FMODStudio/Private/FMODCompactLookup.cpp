@@ -0,0 +1,360 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODCompactLookup.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "FMODStudioPrivatePCH.h"
+
+static const uint32 LookupMagic = 0x4B4C4D46; // 'FMLK'
+static const uint32 LookupVersion = 1;
+
+static const uint32 HasEventBanksFlag = 1 << 0;
+
+// Every section is an array of fixed size entries, with strings stored once each as null terminated UTF-8 in a pool
+// at the end. String offsets are relative to the pool, where offset zero is the empty string.
+struct UFMODCompactLookup::FHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint32 Flags;
+    uint32 AssetCount;
+    uint32 AssetOffset;
+    uint32 BankCount;
+    uint32 BankOffset;
+    uint32 BankPathCount;
+    uint32 BankPathOffset;
+    uint32 EventCount;
+    uint32 EventOffset;
+    uint32 EventBankCount;
+    uint32 EventBankOffset;
+    uint32 StringOffset;
+    uint32 StringSize;
+    uint32 MasterBankPath;
+    uint32 MasterAssetsBankPath;
+    uint32 MasterStringsBankPath;
+};
+
+// Sorted by hash, with the case-insensitive match made on the path itself
+struct FFMODCompactAssetEntry
+{
+    uint32 Hash;
+    uint32 StudioPath;
+    uint32 PackageName;
+    uint32 AssetName;
+};
+
+// In the order they were built, which is the order banks are loaded in
+struct FFMODCompactBankEntry
+{
+    FGuid Guid;
+    uint32 FirstPath;
+    uint32 PathCount;
+};
+
+struct FFMODCompactBankPathEntry
+{
+    uint32 Locale;
+    uint32 Path;
+};
+
+// Sorted by GUID, indexing into an array of bank GUIDs
+struct FFMODCompactEventEntry
+{
+    FGuid Guid;
+    uint32 FirstBank;
+    uint32 BankCount;
+};
+
+struct FCaseSensitiveStringKeyFuncs : BaseKeyFuncs<TPair<FString, uint32>, FString>
+{
+    static const FString &GetSetKey(const TPair<FString, uint32> &Element) { return Element.Key; }
+    static bool Matches(const FString &A, const FString &B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+    static uint32 GetKeyHash(const FString &Key) { return FCrc::StrCrc32(*Key); }
+};
+
+static uint32 HashStudioPath(const FString &StudioPath)
+{
+    // Studio paths were looked up by FName, so matching stays case-insensitive
+    return FCrc::StrCrc32(*StudioPath.ToLower());
+}
+
+template <typename EntryType>
+static void AppendEntries(TArray<uint8> &Data, uint32 &Offset, const TArray<EntryType> &Entries)
+{
+    Offset = Data.Num();
+    Data.Append(reinterpret_cast<const uint8 *>(Entries.GetData()), Entries.Num() * sizeof(EntryType));
+}
+
+UFMODCompactLookup::UFMODCompactLookup(const FObjectInitializer &ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+}
+
+void UFMODCompactLookup::Serialize(FArchive &Ar)
+{
+    Super::Serialize(Ar);
+    Ar << Data;
+}
+
+bool UFMODCompactLookup::IsValidLookup() const
+{
+    if (Data.Num() < (int32)sizeof(FHeader))
+    {
+        return false;
+    }
+
+    const FHeader &Header = GetHeader();
+    if (Header.Magic != LookupMagic || Header.Version != LookupVersion)
+    {
+        return false;
+    }
+
+    auto SectionFits = [this](uint64 Offset, uint64 Count, uint64 EntrySize) {
+        return Offset + Count * EntrySize <= (uint64)Data.Num();
+    };
+
+    return SectionFits(Header.AssetOffset, Header.AssetCount, sizeof(FFMODCompactAssetEntry)) &&
+           SectionFits(Header.BankOffset, Header.BankCount, sizeof(FFMODCompactBankEntry)) &&
+           SectionFits(Header.BankPathOffset, Header.BankPathCount, sizeof(FFMODCompactBankPathEntry)) &&
+           SectionFits(Header.EventOffset, Header.EventCount, sizeof(FFMODCompactEventEntry)) &&
+           SectionFits(Header.EventBankOffset, Header.EventBankCount, sizeof(FGuid)) &&
+           SectionFits(Header.StringOffset, Header.StringSize, 1) && Header.StringSize > 0;
+}
+
+bool UFMODCompactLookup::Build(const TArray<FAsset> &Assets, const TArray<FBank> &Banks, const TMap<FGuid, TArray<FGuid>> *EventBanks,
+    const FString &MasterBankPath, const FString &MasterAssetsBankPath, const FString &MasterStringsBankPath)
+{
+    TArray<uint8> Strings;
+    TMap<FString, uint32, FDefaultSetAllocator, FCaseSensitiveStringKeyFuncs> StringOffsets;
+    Strings.Add(0);
+
+    auto AddString = [&](const FString &String) -> uint32 {
+        if (String.IsEmpty())
+        {
+            return 0;
+        }
+        if (const uint32 *Existing = StringOffsets.Find(String))
+        {
+            return *Existing;
+        }
+
+        uint32 Offset = Strings.Num();
+        FTCHARToUTF8 Converted(*String);
+        Strings.Append(reinterpret_cast<const uint8 *>(Converted.Get()), Converted.Length());
+        Strings.Add(0);
+        StringOffsets.Add(String, Offset);
+        return Offset;
+    };
+
+    TArray<FFMODCompactAssetEntry> AssetEntries;
+    AssetEntries.Reserve(Assets.Num());
+    for (const FAsset &Asset : Assets)
+    {
+        FFMODCompactAssetEntry &Entry = AssetEntries.AddDefaulted_GetRef();
+        Entry.Hash = HashStudioPath(Asset.StudioPath);
+        Entry.StudioPath = AddString(Asset.StudioPath);
+        Entry.PackageName = AddString(Asset.PackageName);
+        Entry.AssetName = AddString(Asset.AssetName);
+    }
+    Algo::SortBy(AssetEntries, &FFMODCompactAssetEntry::Hash);
+
+    TArray<FFMODCompactBankEntry> BankEntries;
+    TArray<FFMODCompactBankPathEntry> BankPathEntries;
+    BankEntries.Reserve(Banks.Num());
+    for (const FBank &Bank : Banks)
+    {
+        FFMODCompactBankEntry &Entry = BankEntries.AddDefaulted_GetRef();
+        Entry.Guid = Bank.Guid;
+        Entry.FirstPath = BankPathEntries.Num();
+        Entry.PathCount = Bank.Paths.Num();
+
+        for (const TPair<FString, FString> &Path : Bank.Paths)
+        {
+            FFMODCompactBankPathEntry &PathEntry = BankPathEntries.AddDefaulted_GetRef();
+            PathEntry.Locale = AddString(Path.Key);
+            PathEntry.Path = AddString(Path.Value);
+        }
+    }
+
+    TArray<FGuid> EventGuids;
+    if (EventBanks)
+    {
+        EventBanks->GetKeys(EventGuids);
+    }
+    EventGuids.Sort();
+
+    TArray<FFMODCompactEventEntry> EventEntries;
+    TArray<FGuid> EventBankGuids;
+    EventEntries.Reserve(EventGuids.Num());
+    for (const FGuid &EventGuid : EventGuids)
+    {
+        const TArray<FGuid> &EventBankList = (*EventBanks)[EventGuid];
+
+        FFMODCompactEventEntry &Entry = EventEntries.AddDefaulted_GetRef();
+        Entry.Guid = EventGuid;
+        Entry.FirstBank = EventBankGuids.Num();
+        Entry.BankCount = EventBankList.Num();
+        EventBankGuids.Append(EventBankList);
+    }
+
+    FHeader Header;
+    FMemory::Memzero(Header);
+    Header.Magic = LookupMagic;
+    Header.Version = LookupVersion;
+    Header.Flags = EventBanks ? HasEventBanksFlag : 0;
+    Header.AssetCount = AssetEntries.Num();
+    Header.BankCount = BankEntries.Num();
+    Header.BankPathCount = BankPathEntries.Num();
+    Header.EventCount = EventEntries.Num();
+    Header.EventBankCount = EventBankGuids.Num();
+    Header.MasterBankPath = AddString(MasterBankPath);
+    Header.MasterAssetsBankPath = AddString(MasterAssetsBankPath);
+    Header.MasterStringsBankPath = AddString(MasterStringsBankPath);
+
+    TArray<uint8> NewData;
+    NewData.AddZeroed(sizeof(FHeader));
+    AppendEntries(NewData, Header.AssetOffset, AssetEntries);
+    AppendEntries(NewData, Header.BankOffset, BankEntries);
+    AppendEntries(NewData, Header.BankPathOffset, BankPathEntries);
+    AppendEntries(NewData, Header.EventOffset, EventEntries);
+    AppendEntries(NewData, Header.EventBankOffset, EventBankGuids);
+    Header.StringSize = Strings.Num();
+    AppendEntries(NewData, Header.StringOffset, Strings);
+    FMemory::Memcpy(NewData.GetData(), &Header, sizeof(FHeader));
+
+    if (NewData == Data)
+    {
+        return false;
+    }
+
+    Data = MoveTemp(NewData);
+    return true;
+}
+
+bool UFMODCompactLookup::FindAsset(const FString &StudioPath, FString &PackageName, FString &AssetName) const
+{
+    const FHeader &Header = GetHeader();
+    TArrayView<const FFMODCompactAssetEntry> Entries(GetEntries<FFMODCompactAssetEntry>(Header.AssetOffset), Header.AssetCount);
+
+    uint32 Hash = HashStudioPath(StudioPath);
+    for (int32 i = Algo::LowerBoundBy(Entries, Hash, &FFMODCompactAssetEntry::Hash); i < Entries.Num() && Entries[i].Hash == Hash; ++i)
+    {
+        if (FCString::Stricmp(*StudioPath, *GetString(Entries[i].StudioPath)) == 0)
+        {
+            PackageName = GetString(Entries[i].PackageName);
+            AssetName = GetString(Entries[i].AssetName);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void UFMODCompactLookup::ForEachBank(const FString &Locale, TFunctionRef<void(const FGuid &, const FString &)> Visitor) const
+{
+    const FHeader &Header = GetHeader();
+    const FFMODCompactBankEntry *Banks = GetEntries<FFMODCompactBankEntry>(Header.BankOffset);
+    const FFMODCompactBankPathEntry *Paths = GetEntries<FFMODCompactBankPathEntry>(Header.BankPathOffset);
+    FString NonLocalized = NonLocalizedName();
+
+    for (uint32 i = 0; i < Header.BankCount; ++i)
+    {
+        const FFMODCompactBankPathEntry *Match = nullptr;
+
+        for (uint32 j = Banks[i].FirstPath; j < Banks[i].FirstPath + Banks[i].PathCount && j < Header.BankPathCount; ++j)
+        {
+            FString PathLocale = GetString(Paths[j].Locale);
+            if (PathLocale.Equals(Locale, ESearchCase::IgnoreCase))
+            {
+                Match = &Paths[j];
+                break;
+            }
+            if (!Match && PathLocale == NonLocalized)
+            {
+                Match = &Paths[j];
+            }
+        }
+
+        if (Match)
+        {
+            Visitor(Banks[i].Guid, GetString(Match->Path));
+        }
+    }
+}
+
+bool UFMODCompactLookup::HasEventBanks() const
+{
+    return (GetHeader().Flags & HasEventBanksFlag) != 0;
+}
+
+bool UFMODCompactLookup::FindEventBanks(const FGuid &EventGuid, TArray<FGuid> &Banks) const
+{
+    const FHeader &Header = GetHeader();
+    TArrayView<const FFMODCompactEventEntry> Entries(GetEntries<FFMODCompactEventEntry>(Header.EventOffset), Header.EventCount);
+
+    int32 Index = Algo::BinarySearchBy(Entries, EventGuid, &FFMODCompactEventEntry::Guid);
+    if (Index == INDEX_NONE)
+    {
+        return false;
+    }
+
+    const FFMODCompactEventEntry &Entry = Entries[Index];
+    if (Entry.FirstBank + Entry.BankCount > Header.EventBankCount)
+    {
+        return false;
+    }
+
+    Banks.Append(GetEntries<FGuid>(Header.EventBankOffset) + Entry.FirstBank, Entry.BankCount);
+    return true;
+}
+
+FString UFMODCompactLookup::GetMasterBankPath() const
+{
+    return GetString(GetHeader().MasterBankPath);
+}
+
+FString UFMODCompactLookup::GetMasterAssetsBankPath() const
+{
+    return GetString(GetHeader().MasterAssetsBankPath);
+}
+
+FString UFMODCompactLookup::GetMasterStringsBankPath() const
+{
+    return GetString(GetHeader().MasterStringsBankPath);
+}
+
+int32 UFMODCompactLookup::GetAssetCount() const
+{
+    return GetHeader().AssetCount;
+}
+
+int32 UFMODCompactLookup::GetBankCount() const
+{
+    return GetHeader().BankCount;
+}
+
+const UFMODCompactLookup::FHeader &UFMODCompactLookup::GetHeader() const
+{
+    return *reinterpret_cast<const FHeader *>(Data.GetData());
+}
+
+template <typename EntryType>
+const EntryType *UFMODCompactLookup::GetEntries(uint32 Offset) const
+{
+    return reinterpret_cast<const EntryType *>(Data.GetData() + Offset);
+}
+
+FString UFMODCompactLookup::GetString(uint32 Offset) const
+{
+    return FString(UTF8_TO_TCHAR(GetStringData(Offset)));
+}
+
+const ANSICHAR *UFMODCompactLookup::GetStringData(uint32 Offset) const
+{
+    const FHeader &Header = GetHeader();
+    if (Offset >= Header.StringSize)
+    {
+        Offset = 0;
+    }
+    return reinterpret_cast<const ANSICHAR *>(Data.GetData() + Header.StringOffset + Offset);
+}
@@ -0,0 +1,75 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "FMODCompactLookup.generated.h"
+
+/**
+ * The asset and bank lookups in one sorted binary blob, generated from the lookup DataTables when assets are built.
+ * Loading it is a single array read, and queries binary search the blob in place rather than building row structs,
+ * nested tables and FNames for every asset and bank. The DataTables are kept as the editable view of the same data.
+ */
+UCLASS()
+class FMODSTUDIO_API UFMODCompactLookup : public UObject
+{
+    GENERATED_UCLASS_BODY()
+
+public:
+    struct FAsset
+    {
+        FString StudioPath;
+        FString PackageName;
+        FString AssetName;
+    };
+
+    struct FBank
+    {
+        FGuid Guid;
+
+        /** Paths by locale code, with non-localized banks under NonLocalizedName() */
+        TArray<TPair<FString, FString>> Paths;
+    };
+
+    //~ UObject
+    virtual void Serialize(FArchive &Ar) override;
+
+    /** True if the data is a lookup this version can read */
+    bool IsValidLookup() const;
+
+    /** Rebuild the data, returning true if it changed. EventBanks is null if event dependencies weren't recorded */
+    bool Build(const TArray<FAsset> &Assets, const TArray<FBank> &Banks, const TMap<FGuid, TArray<FGuid>> *EventBanks,
+        const FString &MasterBankPath, const FString &MasterAssetsBankPath, const FString &MasterStringsBankPath);
+
+    bool FindAsset(const FString &StudioPath, FString &PackageName, FString &AssetName) const;
+
+    /** Call Visitor with the GUID and path of each bank for a locale, falling back to the non-localized path */
+    void ForEachBank(const FString &Locale, TFunctionRef<void(const FGuid &, const FString &)> Visitor) const;
+
+    /** True if event dependencies were recorded when the lookup was built */
+    bool HasEventBanks() const;
+    bool FindEventBanks(const FGuid &EventGuid, TArray<FGuid> &Banks) const;
+
+    FString GetMasterBankPath() const;
+    FString GetMasterAssetsBankPath() const;
+    FString GetMasterStringsBankPath() const;
+
+    int32 GetAssetCount() const;
+    int32 GetBankCount() const;
+
+    static inline FString NonLocalizedName() { return FString(TEXT("<NON-LOCALIZED>")); }
+
+private:
+    struct FHeader;
+
+    const FHeader &GetHeader() const;
+
+    template <typename EntryType>
+    const EntryType *GetEntries(uint32 Offset) const;
+
+    FString GetString(uint32 Offset) const;
+    const ANSICHAR *GetStringData(uint32 Offset) const;
+
+    TArray<uint8> Data;
+};
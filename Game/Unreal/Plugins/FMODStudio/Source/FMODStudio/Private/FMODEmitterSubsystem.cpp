@@ -0,0 +1,57 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODEmitterSubsystem.h"
+#include "FMODAudioComponent.h"
+#include "fmod_studio.hpp"
+#include "FMODStudioPrivatePCH.h"
+
+void UFMODEmitterSubsystem::MarkDirty(UFMODAudioComponent *Component, bool bTransformChanged)
+{
+    bool &bQueuedTransformChanged = DirtyEmitters.FindOrAdd(Component, false);
+    bQueuedTransformChanged |= bTransformChanged;
+}
+
+void UFMODEmitterSubsystem::Tick(float DeltaTime)
+{
+    if (DirtyEmitters.Num() == 0)
+    {
+        return;
+    }
+
+    // Moved out first, so anything marked while updating is kept for the next frame
+    TMap<TWeakObjectPtr<UFMODAudioComponent>, bool> Emitters = MoveTemp(DirtyEmitters);
+    DirtyEmitters.Reset();
+
+    TArray<UFMODAudioComponent *, TInlineAllocator<64>> Moved;
+    TArray<FMOD_3D_ATTRIBUTES, TInlineAllocator<64>> Attributes;
+
+    for (const TPair<TWeakObjectPtr<UFMODAudioComponent>, bool> &Pair : Emitters)
+    {
+        UFMODAudioComponent *Component = Pair.Key.Get();
+        if (Pair.Value && Component && Component->StudioInstance)
+        {
+            Moved.Add(Component);
+            Component->Get3DAttributes(Attributes.AddDefaulted_GetRef());
+        }
+    }
+
+    for (int32 i = 0; i < Moved.Num(); ++i)
+    {
+        Moved[i]->StudioInstance->set3DAttributes(&Attributes[i]);
+    }
+
+    // Interior volumes and occlusion are measured from the positions just submitted
+    for (const TPair<TWeakObjectPtr<UFMODAudioComponent>, bool> &Pair : Emitters)
+    {
+        UFMODAudioComponent *Component = Pair.Key.Get();
+        if (Component && Component->StudioInstance)
+        {
+            Component->UpdateEnvironment();
+        }
+    }
+}
+
+TStatId UFMODEmitterSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UFMODEmitterSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,34 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FMODEmitterSubsystem.generated.h"
+
+class UFMODAudioComponent;
+
+/**
+ * Collects audio components whose transform or listener relationship changed during the frame and updates them once,
+ * after the world has ticked and before the Studio system update. A component that moves several times in a frame,
+ * such as one attached to a physics body with substepping, is converted and submitted to FMOD only once.
+ */
+UCLASS()
+class FMODSTUDIO_API UFMODEmitterSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /** Queue a component for this frame's update. bTransformChanged also submits its 3D attributes */
+    void MarkDirty(UFMODAudioComponent *Component, bool bTransformChanged);
+
+    //~ FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    virtual bool IsTickableInEditor() const override { return true; }
+    virtual bool IsTickableWhenPaused() const override { return true; }
+
+private:
+    /** Queued components, with whether their transform changed rather than only the listener */
+    TMap<TWeakObjectPtr<UFMODAudioComponent>, bool> DirtyEmitters;
+};
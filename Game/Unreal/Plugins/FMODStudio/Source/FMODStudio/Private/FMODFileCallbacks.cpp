@@ -4,12 +4,21 @@
 #include "fmod_errors.h"
 #include "FMODUtils.h"
 #include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/AsyncFileHandle.h"
 #include "GenericPlatform/GenericPlatformProcess.h"
 #include "HAL/Runnable.h"
 #include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
 #include "Misc/ScopeLock.h"
+#include "FMODSettings.h"
+#include "FMODFileStats.h"
+#include "FMODIOTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 #include "FMODStudioPrivatePCH.h"
 
+#include <atomic>
+
 FMOD_RESULT F_CALLBACK FMODLogCallback(FMOD_DEBUG_FLAGS flags, const char *file, int line, const char *func, const char *message)
 {
     if (flags & FMOD_DEBUG_LEVEL_ERROR)
@@ -59,24 +68,139 @@ FMOD_RESULT F_CALLBACK FMODErrorCallback(FMOD_SYSTEM *system, FMOD_SYSTEM_CALLBA
     return FMOD_OK;
 }
 
-class FFMODFileSystem : public FRunnable
+// An asynchronous read issued on behalf of FMOD through FMOD_FILE_ASYNCREAD_CALLBACK
+struct FFMODAsyncRead
+{
+    FFMODAsyncRead(FMOD_ASYNCREADINFO *InInfo, unsigned int InSizeBytes)
+        : Info(InInfo)
+        , SizeBytes(InSizeBytes)
+        , Request(nullptr)
+        , PublishedEvent(nullptr)
+        , StartCycles(FPlatformTime::Cycles64())
+        , bDone(false)
+    {
+    }
+
+    FMOD_ASYNCREADINFO *Info;
+    unsigned int SizeBytes;
+    IAsyncReadRequest *Request;
+
+    // Created by a cancel that arrives before the request has been published, and triggered once it has
+    FEvent *PublishedEvent;
+
+    uint64 StartCycles;
+
+    // Set by the completion callback just before FMOD is told the read is complete. The read isn't freed until
+    // WaitCompletion has returned, so the callback has always finished with it by then
+    bool bDone;
+};
+
+// A block of file data held by the read-ahead cache
+struct FFMODFileBlock
+{
+    FFMODFileBlock()
+        : Offset(-1)
+        , Size(0)
+        , LastUsed(0)
+    {
+    }
+
+    int64 Offset;
+    int32 Size;
+    uint64 LastUsed;
+    TArray<uint8> Data;
+};
+
+// A platform file handle shared by every FMOD handle open on the same path
+struct FFMODSharedFile
+{
+    FFMODSharedFile(const FString &InName, IFileHandle *InHandle)
+        : Name(InName)
+        , Handle(InHandle)
+        , Size(InHandle->Size())
+        , RefCount(0)
+        , AsyncHandle(nullptr)
+    {
+    }
+
+    FString Name;
+    IFileHandle *Handle;
+    int64 Size;
+
+    // Number of FMOD handles using this file, guarded by the file system's shared file lock
+    int32 RefCount;
+
+    // Serializes positional reads on the platform handle
+    FCriticalSection Crit;
+
+    // Created on the first asynchronous read from any handle on this file
+    IAsyncReadFileHandle *AsyncHandle;
+    FCriticalSection AsyncCrit;
+};
+
+// Per-handle state for a file opened by FMOD
+struct FFMODFileHandle
+{
+    FFMODFileHandle(FFMODSharedFile *InShared, EFMODFileClass::Type InClass, int32 InBlockSize, int32 InBlockCount)
+        : Shared(InShared)
+        , Name(InShared->Name)
+        , Class(InClass)
+        , Size(InShared->Size)
+        , Position(0)
+        , BlockSize(InBlockSize)
+        , UseCounter(0)
+        , CacheHits(0)
+        , CacheMisses(0)
+        , CacheBypassed(0)
+        , StatsHandleId(0)
+        , Stats(FFMODFileStats::OpenFile(InShared->Name, StatsHandleId))
+    {
+        if (BlockSize > 0)
+        {
+            Blocks.SetNum(InBlockCount);
+        }
+    }
+
+    FFMODSharedFile *Shared;
+    FString Name;
+    EFMODFileClass::Type Class;
+    int64 Size;
+
+    // Logical read position; the shared file is only seeked when data has to come from disk
+    int64 Position;
+
+    // Read-ahead cache, empty when disabled
+    int32 BlockSize;
+    TArray<FFMODFileBlock> Blocks;
+    uint64 UseCounter;
+    uint64 CacheHits;
+    uint64 CacheMisses;
+    uint64 CacheBypassed;
+
+    // Identifies this handle's reads and seeks in the trace
+    uint32 StatsHandleId;
+
+    // Telemetry shared by every handle opened on this file
+    FFMODFileRecord *Stats;
+
+    // Serializes commands issued against this handle; different handles are serviced in parallel
+    FCriticalSection Crit;
+
+    // Asynchronous reads still owned by this handle
+    TArray<FFMODAsyncRead *> AsyncReads;
+    FCriticalSection AsyncCrit;
+};
+
+class FFMODFileSystem
 {
 public:
     FFMODFileSystem()
-        : mHandleIn(nullptr)
-        , mName(nullptr)
-        , mFileSize(nullptr)
-        , mHandleOut(nullptr)
-        , mBuffer(nullptr)
-        , mSizeBytes(0)
-        , mBytesRead(nullptr)
-        , mSeekPosition(0)
-        , mCommand(COMMAND_MAX)
-        , mResult(FMOD_OK)
-        , mReferenceCount(0)
-        , mThread(nullptr)
-        , mCommandReadyEvent(nullptr)
-        , mCommandCompleteEvent(nullptr)
+        : mReferenceCount(0)
+        , mStopRequested(false)
+        , mWorkReadyEvent(nullptr)
+        , mCacheHits(0)
+        , mCacheMisses(0)
+        , mCacheBypassed(0)
     {
     }
 
@@ -84,12 +208,21 @@ public:
     static FMOD_RESULT F_CALLBACK CloseCallback(void *handle, void * /*userdata*/);
     static FMOD_RESULT F_CALLBACK ReadCallback(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread, void * /*userdata*/);
     static FMOD_RESULT F_CALLBACK SeekCallback(void *handle, unsigned int pos, void * /*userdata*/);
+    static FMOD_RESULT F_CALLBACK AsyncReadCallback(FMOD_ASYNCREADINFO *info, void * /*userdata*/);
+    static FMOD_RESULT F_CALLBACK AsyncCancelCallback(FMOD_ASYNCREADINFO *info, void * /*userdata*/);
 
     static FMOD_RESULT OpenInternal(const char *name, unsigned int *filesize, void **handle);
     static FMOD_RESULT CloseInternal(void *handle);
     static FMOD_RESULT ReadInternal(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread);
     static FMOD_RESULT SeekInternal(void *handle, unsigned int pos);
 
+    void GetCacheStats(uint64 &hits, uint64 &misses, uint64 &bypassed) const
+    {
+        hits = mCacheHits;
+        misses = mCacheMisses;
+        bypassed = mCacheBypassed;
+    }
+
     void IncrementReferenceCount()
     {
         FScopeLock lock(&mCrit);
@@ -98,11 +231,20 @@ public:
 
         if (mReferenceCount == 1)
         {
-            check(!mThread);
+            check(mWorkers.Num() == 0);
+
+            const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+            int32 WorkerCount = FMath::Max(Settings.FileThreadCount, 1);
+
+            mStopRequested = false;
+            mWorkReadyEvent = FGenericPlatformProcess::GetSynchEventFromPool();
 
-            mCommandReadyEvent = FGenericPlatformProcess::GetSynchEventFromPool();
-            mCommandCompleteEvent = FGenericPlatformProcess::GetSynchEventFromPool();
-            mThread = FRunnableThread::Create(this, TEXT("FMOD File Access Coordinator"));
+            for (int32 i = 0; i < WorkerCount; ++i)
+            {
+                FWorker *Worker = new FWorker(*this);
+                Worker->Thread = FRunnableThread::Create(Worker, *FString::Printf(TEXT("FMOD File Worker %d"), i));
+                mWorkers.Add(Worker);
+            }
         }
     }
 
@@ -111,138 +253,308 @@ public:
         FScopeLock lock(&mCrit);
 
         check(mReferenceCount > 0);
-        check(mThread);
+        check(mWorkers.Num() > 0);
 
         --mReferenceCount;
 
         if (mReferenceCount == 0)
         {
-            verifyfmod(RunCommand(COMMAND_STOP));
-            mThread->WaitForCompletion();
+            {
+                FScopeLock queueLock(&mQueueCrit);
+                mStopRequested = true;
+            }
+
+            // Each worker passes the wake up along to the next one as it exits
+            mWorkReadyEvent->Trigger();
+
+            for (FWorker *Worker : mWorkers)
+            {
+                Worker->Thread->WaitForCompletion();
+                delete Worker->Thread;
+                delete Worker;
+            }
+            mWorkers.Reset();
 
-            FGenericPlatformProcess::ReturnSynchEventToPool(mCommandReadyEvent);
-            mCommandReadyEvent = nullptr;
-            FGenericPlatformProcess::ReturnSynchEventToPool(mCommandCompleteEvent);
-            mCommandCompleteEvent = nullptr;
-            delete mThread;
-            mThread = nullptr;
+            FGenericPlatformProcess::ReturnSynchEventToPool(mWorkReadyEvent);
+            mWorkReadyEvent = nullptr;
         }
     }
 
     void Attach(FMOD::System *system, int32 fileBufferSize)
     {
-        check(mThread);
+        check(mWorkers.Num() > 0);
 
-        verifyfmod(system->setFileSystem(OpenCallback, CloseCallback, ReadCallback, SeekCallback, 0, 0, fileBufferSize));
-    }
-
-    uint32 Run() override
-    {
-        bool stopRequested = false;
+        const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
 
-        while (!stopRequested)
+        if (Settings.bEnableAsyncFileReads)
         {
-            mCommandReadyEvent->Wait();
-
-            switch (mCommand)
-            {
-                case COMMAND_OPEN:
-                    mResult = OpenInternal(mName, mFileSize, mHandleOut);
-                    break;
-                case COMMAND_CLOSE:
-                    mResult = CloseInternal(mHandleIn);
-                    break;
-                case COMMAND_READ:
-                    mResult = ReadInternal(mHandleIn, mBuffer, mSizeBytes, mBytesRead);
-                    break;
-                case COMMAND_SEEK:
-                    mResult = SeekInternal(mHandleIn, mSeekPosition);
-                    break;
-                case COMMAND_STOP:
-                    stopRequested = true;
-                    mResult = FMOD_OK;
-                    break;
-            }
-
-            mCommandCompleteEvent->Trigger();
+            verifyfmod(system->setFileSystem(OpenCallback, CloseCallback, ReadCallback, SeekCallback, AsyncReadCallback, AsyncCancelCallback, fileBufferSize));
+        }
+        else
+        {
+            verifyfmod(system->setFileSystem(OpenCallback, CloseCallback, ReadCallback, SeekCallback, 0, 0, fileBufferSize));
         }
-
-        return 0;
     }
 
 private:
+    static EFMODFileClass::Type ClassifyFile(const FString &Name);
+    static double GetDeadlineSeconds(EFMODFileClass::Type Class);
+    static EAsyncIOPriorityAndFlags ConvertPriority(int priority, EFMODFileClass::Type Class);
+    static void ReleaseCompletedAsyncReads(FFMODFileHandle *FileHandle, bool bWaitForAll);
+    static FFMODSharedFile *AcquireSharedFile(const FString &Name);
+    static void ReleaseSharedFile(FFMODSharedFile *Shared);
+    static void ReadFromFile(FFMODFileHandle *FileHandle, int64 Offset, void *Buffer, int64 Length);
+    static const FFMODFileBlock &FindOrLoadBlock(FFMODFileHandle *FileHandle, int64 BlockOffset);
+
     enum Command
     {
         COMMAND_OPEN,
         COMMAND_CLOSE,
         COMMAND_READ,
         COMMAND_SEEK,
-        COMMAND_STOP,
         COMMAND_MAX,
     };
 
-    FMOD_RESULT RunCommand(Command command)
+    // A single request from FMOD, owned by the calling thread until the completion event fires
+    struct FCommand
+    {
+        FCommand(Command InType)
+            : Type(InType)
+            , HandleIn(nullptr)
+            , Name(nullptr)
+            , FileSize(nullptr)
+            , HandleOut(nullptr)
+            , Buffer(nullptr)
+            , SizeBytes(0)
+            , BytesRead(nullptr)
+            , SeekPosition(0)
+            , Result(FMOD_OK)
+            , CompleteEvent(nullptr)
+            , Class(EFMODFileClass::BankMetadata)
+            , EnqueueTime(0.0)
+            , Deadline(0.0)
+        {
+        }
+
+        Command Type;
+
+        // Parameter for Close, Seek and Read
+        FFMODFileHandle *HandleIn;
+
+        // Parameters for Open
+        const char *Name;
+        unsigned int *FileSize;
+        void **HandleOut;
+
+        // Parameters for Read
+        void *Buffer;
+        unsigned int SizeBytes;
+        unsigned int *BytesRead;
+
+        // Parameter for Seek
+        unsigned int SeekPosition;
+
+        FMOD_RESULT Result;
+        FEvent *CompleteEvent;
+
+        // Scheduling, filled in when the command is queued
+        EFMODFileClass::Type Class;
+        double EnqueueTime;
+        double Deadline;
+    };
+
+    class FWorker : public FRunnable
     {
-        check(mThread);
+    public:
+        FWorker(FFMODFileSystem &InOwner)
+            : Owner(InOwner)
+            , Thread(nullptr)
+        {
+        }
+
+        uint32 Run() override
+        {
+            Owner.WorkerLoop();
+            return 0;
+        }
+
+        FFMODFileSystem &Owner;
+        FRunnableThread *Thread;
+    };
 
-        mCommand = command;
-        mCommandReadyEvent->Trigger();
-        mCommandCompleteEvent->Wait();
+    FMOD_RESULT RunCommand(FCommand &command)
+    {
+        command.CompleteEvent = FGenericPlatformProcess::GetSynchEventFromPool();
+        if (command.HandleIn)
+        {
+            command.Class = command.HandleIn->Class;
+        }
+        else if (command.Name)
+        {
+            command.Class = ClassifyFile(UTF8_TO_TCHAR(command.Name));
+        }
+        command.EnqueueTime = FPlatformTime::Seconds();
+        command.Deadline = command.EnqueueTime + GetDeadlineSeconds(command.Class);
 
-        return mResult;
+        {
+            FScopeLock queueLock(&mQueueCrit);
+            check(!mStopRequested);
+            mQueue.Add(&command);
+        }
+        mWorkReadyEvent->Trigger();
+
+        command.CompleteEvent->Wait();
+        FGenericPlatformProcess::ReturnSynchEventToPool(command.CompleteEvent);
+        command.CompleteEvent = nullptr;
+
+        return command.Result;
     }
 
-    // Parameter for Close, Seek and Read
-    void *mHandleIn;
+    void WorkerLoop()
+    {
+        while (true)
+        {
+            FCommand *command = nullptr;
+            bool stopRequested = false;
 
-    // Parameters for Open
-    const char *mName;
-    unsigned int *mFileSize;
-    void **mHandleOut;
+            {
+                FScopeLock queueLock(&mQueueCrit);
 
-    // Parameters for Read
-    void *mBuffer;
-    unsigned int mSizeBytes;
-    unsigned int *mBytesRead;
+                if (mQueue.Num() > 0)
+                {
+                    // Earliest deadline first; ties go to the more urgent class, then to the oldest command
+                    int32 Best = 0;
+                    for (int32 i = 1; i < mQueue.Num(); ++i)
+                    {
+                        if (mQueue[i]->Deadline < mQueue[Best]->Deadline
+                            || (mQueue[i]->Deadline == mQueue[Best]->Deadline && mQueue[i]->Class < mQueue[Best]->Class))
+                        {
+                            Best = i;
+                        }
+                    }
+                    command = mQueue[Best];
+                    mQueue.RemoveAt(Best, 1, false);
+                }
+                stopRequested = mStopRequested;
 
-    // Parameter for Seek
-    unsigned int mSeekPosition;
+                // Wake another worker if there is more to do
+                if (mQueue.Num() > 0)
+                {
+                    mWorkReadyEvent->Trigger();
+                }
+            }
 
-    Command mCommand;
-    FMOD_RESULT mResult;
+            if (command)
+            {
+                if (command->Type == COMMAND_READ)
+                {
+                    CheckDeadline(*command);
+                }
+                ExecuteCommand(*command);
+                command->CompleteEvent->Trigger();
+            }
+            else if (stopRequested)
+            {
+                mWorkReadyEvent->Trigger();
+                break;
+            }
+            else
+            {
+                mWorkReadyEvent->Wait();
+            }
+        }
+    }
 
-    int mReferenceCount;
-    FRunnableThread *mThread;
-    FEvent *mCommandReadyEvent;
-    FEvent *mCommandCompleteEvent;
+    void CheckDeadline(const FCommand &command)
+    {
+        double Now = FPlatformTime::Seconds();
+
+        if (Now > command.Deadline)
+        {
+            FFMODFileStats::RecordDeadlineMiss(command.Class);
+        }
+
+        if (command.Class == EFMODFileClass::StreamRefill && Now - command.EnqueueTime > 0.5 * (command.Deadline - command.EnqueueTime))
+        {
+            FFMODFileStats::RecordNearStarvation();
+        }
+    }
 
+    void ExecuteCommand(FCommand &command)
+    {
+        switch (command.Type)
+        {
+            case COMMAND_OPEN:
+                command.Result = OpenInternal(command.Name, command.FileSize, command.HandleOut);
+                break;
+            case COMMAND_CLOSE:
+                command.Result = CloseInternal(command.HandleIn);
+                break;
+            case COMMAND_READ:
+            {
+                FScopeLock handleLock(&command.HandleIn->Crit);
+                command.Result = ReadInternal(command.HandleIn, command.Buffer, command.SizeBytes, command.BytesRead);
+                break;
+            }
+            case COMMAND_SEEK:
+            {
+                FScopeLock handleLock(&command.HandleIn->Crit);
+                command.Result = SeekInternal(command.HandleIn, command.SeekPosition);
+                break;
+            }
+            default:
+                command.Result = FMOD_ERR_INTERNAL;
+                break;
+        }
+    }
+
+    int mReferenceCount;
+    TArray<FWorker *> mWorkers;
     FCriticalSection mCrit;
+
+    // Pending commands, serviced by deadline by whichever worker is free
+    TArray<FCommand *> mQueue;
+    bool mStopRequested;
+    FEvent *mWorkReadyEvent;
+    FCriticalSection mQueueCrit;
+
+    // Open platform files by normalized path
+    TMap<FString, FFMODSharedFile *> mSharedFiles;
+    FCriticalSection mSharedCrit;
+
+    // Read-ahead cache totals across all handles
+    std::atomic<uint64> mCacheHits;
+    std::atomic<uint64> mCacheMisses;
+    std::atomic<uint64> mCacheBypassed;
 };
 
 static FFMODFileSystem gFileSystem;
 
 FMOD_RESULT F_CALLBACK FFMODFileSystem::OpenCallback(const char *name, unsigned int *filesize, void **handle, void * /*userdata*/)
 {
-    FScopeLock lock(&gFileSystem.mCrit);
-    gFileSystem.mName = name;
-    gFileSystem.mFileSize = filesize;
-    gFileSystem.mHandleOut = handle;
+    FCommand command(COMMAND_OPEN);
+    command.Name = name;
+    command.FileSize = filesize;
+    command.HandleOut = handle;
 
-    return gFileSystem.RunCommand(COMMAND_OPEN);
+    return gFileSystem.RunCommand(command);
 }
 
 FMOD_RESULT FFMODFileSystem::OpenInternal(const char *name, unsigned int *filesize, void **handle)
 {
     if (name)
     {
-        FArchive *Archive = IFileManager::Get().CreateFileReader(UTF8_TO_TCHAR(name));
-        UE_LOG(LogFMOD, Verbose, TEXT("FFMODFileSystem::OpenInternal opening '%s' returned archive %p"), UTF8_TO_TCHAR(name), Archive);
-        if (!Archive)
+        FString Name = UTF8_TO_TCHAR(name);
+        FFMODSharedFile *Shared = AcquireSharedFile(Name);
+        UE_LOG(LogFMOD, Verbose, TEXT("FFMODFileSystem::OpenInternal opening '%s' returned shared file %p"), *Name, Shared);
+        if (!Shared)
         {
             return FMOD_ERR_FILE_NOTFOUND;
         }
-        *filesize = Archive->TotalSize();
-        *handle = Archive;
+        const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+
+        *filesize = (unsigned int)Shared->Size;
+        *handle = new FFMODFileHandle(Shared, ClassifyFile(Name), Settings.FileCacheBlockSize, FMath::Max(Settings.FileCacheBlockCount, 1));
         UE_LOG(LogFMOD, Verbose, TEXT("  TotalSize = %d"), *filesize);
     }
 
@@ -251,10 +563,15 @@ FMOD_RESULT FFMODFileSystem::OpenInternal(const char *name, unsigned int *filesi
 
 FMOD_RESULT F_CALLBACK FFMODFileSystem::CloseCallback(void *handle, void * /*userdata*/)
 {
-    FScopeLock lock(&gFileSystem.mCrit);
-    gFileSystem.mHandleIn = handle;
+    if (!handle)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
 
-    return gFileSystem.RunCommand(COMMAND_CLOSE);
+    FCommand command(COMMAND_CLOSE);
+    command.HandleIn = (FFMODFileHandle *)handle;
+
+    return gFileSystem.RunCommand(command);
 }
 
 FMOD_RESULT FFMODFileSystem::CloseInternal(void *handle)
@@ -264,22 +581,39 @@ FMOD_RESULT FFMODFileSystem::CloseInternal(void *handle)
         return FMOD_ERR_INVALID_PARAM;
     }
 
-    FArchive *Archive = (FArchive *)handle;
-    UE_LOG(LogFMOD, Verbose, TEXT("FFMODFileSystem::CloseCallback closing archive %p"), Archive);
-    delete Archive;
+    FFMODFileHandle *FileHandle = (FFMODFileHandle *)handle;
+    UE_LOG(LogFMOD, Verbose, TEXT("FFMODFileSystem::CloseCallback closing shared file %p"), FileHandle->Shared);
+
+    // FMOD has already waited for or cancelled its reads, but the requests themselves may not be released yet
+    ReleaseCompletedAsyncReads(FileHandle, true);
+
+    if (FileHandle->Blocks.Num() > 0)
+    {
+        uint64 Lookups = FileHandle->CacheHits + FileHandle->CacheMisses;
+        UE_LOG(LogFMOD, Verbose, TEXT("  Cache hits %llu / %llu (%.1f%%), %llu bypassed"), FileHandle->CacheHits, Lookups,
+            Lookups ? 100.0 * FileHandle->CacheHits / Lookups : 0.0, FileHandle->CacheBypassed);
+    }
+
+    ReleaseSharedFile(FileHandle->Shared);
+    delete FileHandle;
 
     return FMOD_OK;
 }
 
 FMOD_RESULT F_CALLBACK FFMODFileSystem::ReadCallback(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread, void * /*userdata*/)
 {
-    FScopeLock lock(&gFileSystem.mCrit);
-    gFileSystem.mHandleIn = handle;
-    gFileSystem.mBuffer = buffer;
-    gFileSystem.mSizeBytes = sizebytes;
-    gFileSystem.mBytesRead = bytesread;
+    if (!handle)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
+
+    FCommand command(COMMAND_READ);
+    command.HandleIn = (FFMODFileHandle *)handle;
+    command.Buffer = buffer;
+    command.SizeBytes = sizebytes;
+    command.BytesRead = bytesread;
 
-    return gFileSystem.RunCommand(COMMAND_READ);
+    return gFileSystem.RunCommand(command);
 }
 
 FMOD_RESULT FFMODFileSystem::ReadInternal(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread)
@@ -291,13 +625,68 @@ FMOD_RESULT FFMODFileSystem::ReadInternal(void *handle, void *buffer, unsigned i
 
     if (bytesread)
     {
-        FArchive *Archive = (FArchive *)handle;
+        TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(FMODFileRead, FMODFileChannel);
+
+        FFMODFileHandle *FileHandle = (FFMODFileHandle *)handle;
+        uint64 StartCycles = FPlatformTime::Cycles64();
+        int64 StartPosition = FileHandle->Position;
 
-        int64 BytesLeft = Archive->TotalSize() - Archive->Tell();
+        int64 BytesLeft = FMath::Max<int64>(FileHandle->Size - FileHandle->Position, 0);
         int64 ReadAmount = FMath::Min((int64)sizebytes, BytesLeft);
 
-        Archive->Serialize(buffer, ReadAmount);
+        if (FileHandle->Blocks.Num() == 0)
+        {
+            ReadFromFile(FileHandle, FileHandle->Position, buffer, ReadAmount);
+        }
+        else
+        {
+            uint8 *Dest = (uint8 *)buffer;
+            int64 Offset = FileHandle->Position;
+            int64 Remaining = ReadAmount;
+
+            while (Remaining > 0)
+            {
+                int64 BlockOffset = Offset - (Offset % FileHandle->BlockSize);
+                int64 BlockEnd = BlockOffset + FileHandle->BlockSize;
+                bool bCached = false;
+
+                for (const FFMODFileBlock &Block : FileHandle->Blocks)
+                {
+                    if (Block.Offset == BlockOffset)
+                    {
+                        bCached = true;
+                        break;
+                    }
+                }
+
+                // Large reads gain nothing from being copied through the cache
+                if (!bCached && Remaining >= FileHandle->BlockSize)
+                {
+                    ReadFromFile(FileHandle, Offset, Dest, Remaining);
+                    ++FileHandle->CacheBypassed;
+                    ++gFileSystem.mCacheBypassed;
+                    break;
+                }
+
+                const FFMODFileBlock &Block = FindOrLoadBlock(FileHandle, BlockOffset);
+                int64 CopyAmount = FMath::Min(Remaining, FMath::Min(BlockEnd, BlockOffset + Block.Size) - Offset);
+                if (CopyAmount <= 0)
+                {
+                    break;
+                }
+
+                FMemory::Memcpy(Dest, Block.Data.GetData() + (Offset - BlockOffset), CopyAmount);
+                Dest += CopyAmount;
+                Offset += CopyAmount;
+                Remaining -= CopyAmount;
+            }
+        }
+
+        FileHandle->Position += ReadAmount;
         *bytesread = (unsigned int)ReadAmount;
+
+        FFMODFileStats::RecordRead(FileHandle->Stats, FileHandle->StatsHandleId, StartPosition, (uint32)ReadAmount, StartCycles, false);
+        FFMODIOTrace::RecordAccess(FileHandle->Name, StartPosition, ReadAmount);
         if (ReadAmount < (int64)sizebytes)
         {
             UE_LOG(LogFMOD, Verbose, TEXT(" -> EOF "));
@@ -310,11 +699,16 @@ FMOD_RESULT FFMODFileSystem::ReadInternal(void *handle, void *buffer, unsigned i
 
 FMOD_RESULT F_CALLBACK FFMODFileSystem::SeekCallback(void *handle, unsigned int pos, void * /*userdata*/)
 {
-    FScopeLock lock(&gFileSystem.mCrit);
-    gFileSystem.mHandleIn = handle;
-    gFileSystem.mSeekPosition = pos;
+    if (!handle)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
 
-    return gFileSystem.RunCommand(COMMAND_SEEK);
+    FCommand command(COMMAND_SEEK);
+    command.HandleIn = (FFMODFileHandle *)handle;
+    command.SeekPosition = pos;
+
+    return gFileSystem.RunCommand(command);
 }
 
 FMOD_RESULT FFMODFileSystem::SeekInternal(void *handle, unsigned int pos)
@@ -324,8 +718,383 @@ FMOD_RESULT FFMODFileSystem::SeekInternal(void *handle, unsigned int pos)
         return FMOD_ERR_INVALID_PARAM;
     }
 
-    FArchive *Archive = (FArchive *)handle;
-    Archive->Seek(pos);
+    FFMODFileHandle *FileHandle = (FFMODFileHandle *)handle;
+
+    if (FileHandle->Position != pos)
+    {
+        FFMODFileStats::RecordSeek(FileHandle->Stats, FileHandle->StatsHandleId, pos);
+        FileHandle->Position = pos;
+    }
+
+    return FMOD_OK;
+}
+
+FFMODSharedFile *FFMODFileSystem::AcquireSharedFile(const FString &Name)
+{
+    FString Key = Name;
+    FPaths::NormalizeFilename(Key);
+
+    {
+        FScopeLock lock(&gFileSystem.mSharedCrit);
+
+        if (FFMODSharedFile **Existing = gFileSystem.mSharedFiles.Find(Key))
+        {
+            ++(*Existing)->RefCount;
+            return *Existing;
+        }
+    }
+
+    // Opening can be slow in pak and IoStore builds, so don't hold up other opens while it happens
+    IFileHandle *Handle = FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Name);
+    if (!Handle)
+    {
+        return nullptr;
+    }
+
+    FScopeLock lock(&gFileSystem.mSharedCrit);
+
+    FFMODSharedFile *&Shared = gFileSystem.mSharedFiles.FindOrAdd(Key);
+    if (Shared)
+    {
+        // Another worker opened the same file in the meantime
+        delete Handle;
+    }
+    else
+    {
+        Shared = new FFMODSharedFile(Name, Handle);
+    }
+    ++Shared->RefCount;
+
+    return Shared;
+}
+
+void FFMODFileSystem::ReleaseSharedFile(FFMODSharedFile *Shared)
+{
+    {
+        FScopeLock lock(&gFileSystem.mSharedCrit);
+
+        check(Shared->RefCount > 0);
+        if (--Shared->RefCount > 0)
+        {
+            return;
+        }
+
+        FString Key = Shared->Name;
+        FPaths::NormalizeFilename(Key);
+        gFileSystem.mSharedFiles.Remove(Key);
+    }
+
+    delete Shared->AsyncHandle;
+    delete Shared->Handle;
+    delete Shared;
+}
+
+void FFMODFileSystem::ReadFromFile(FFMODFileHandle *FileHandle, int64 Offset, void *Buffer, int64 Length)
+{
+    FFMODSharedFile *Shared = FileHandle->Shared;
+
+    // Each logical handle keeps its own position, so every read seeks the shared handle if needed
+    FScopeLock lock(&Shared->Crit);
+
+    if (Shared->Handle->Tell() != Offset)
+    {
+        Shared->Handle->Seek(Offset);
+    }
+    Shared->Handle->Read((uint8 *)Buffer, Length);
+}
+
+const FFMODFileBlock &FFMODFileSystem::FindOrLoadBlock(FFMODFileHandle *FileHandle, int64 BlockOffset)
+{
+    FFMODFileBlock *Victim = &FileHandle->Blocks[0];
+
+    for (FFMODFileBlock &Block : FileHandle->Blocks)
+    {
+        if (Block.Offset == BlockOffset)
+        {
+            Block.LastUsed = ++FileHandle->UseCounter;
+            ++FileHandle->CacheHits;
+            ++gFileSystem.mCacheHits;
+            return Block;
+        }
+
+        if (Block.LastUsed < Victim->LastUsed)
+        {
+            Victim = &Block;
+        }
+    }
+
+    ++FileHandle->CacheMisses;
+    ++gFileSystem.mCacheMisses;
+
+    Victim->Offset = BlockOffset;
+    Victim->Size = (int32)FMath::Min<int64>(FileHandle->BlockSize, FileHandle->Size - BlockOffset);
+    Victim->LastUsed = ++FileHandle->UseCounter;
+    Victim->Data.SetNumUninitialized(FileHandle->BlockSize, false);
+    ReadFromFile(FileHandle, BlockOffset, Victim->Data.GetData(), Victim->Size);
+
+    return *Victim;
+}
+
+EFMODFileClass::Type FFMODFileSystem::ClassifyFile(const FString &Name)
+{
+    // Banks built with separate metadata and assets write streaming data to .streams.bank and sample data to .assets.bank
+    if (Name.EndsWith(TEXT(".streams.bank")))
+    {
+        return EFMODFileClass::StreamRefill;
+    }
+    else if (Name.EndsWith(TEXT(".assets.bank")))
+    {
+        return EFMODFileClass::SampleData;
+    }
+    else if (Name.EndsWith(TEXT(".bank")))
+    {
+        return EFMODFileClass::BankMetadata;
+    }
+
+    // Anything else was opened by name through createSound, such as programmer sounds
+    return EFMODFileClass::ProgrammerSound;
+}
+
+double FFMODFileSystem::GetDeadlineSeconds(EFMODFileClass::Type Class)
+{
+    const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+    double StreamDeadline = FMath::Max(Settings.FileStreamDeadlineMs, 1) / 1000.0;
+
+    // Other classes are scheduled relative to streams so a single setting scales the whole policy
+    switch (Class)
+    {
+        case EFMODFileClass::StreamRefill:
+            return StreamDeadline;
+        case EFMODFileClass::ProgrammerSound:
+            return StreamDeadline * 2.0;
+        case EFMODFileClass::BankMetadata:
+            return StreamDeadline * 5.0;
+        default:
+            return StreamDeadline * 10.0;
+    }
+}
+
+EAsyncIOPriorityAndFlags FFMODFileSystem::ConvertPriority(int priority, EFMODFileClass::Type Class)
+{
+    // FMOD priorities run from 0 (low importance) to 100 (must have the data now)
+    if (priority >= 100)
+    {
+        if (Class == EFMODFileClass::StreamRefill)
+        {
+            FFMODFileStats::RecordNearStarvation();
+        }
+        return AIOP_CriticalPath;
+    }
+    else if (priority >= 75 || Class == EFMODFileClass::StreamRefill)
+    {
+        return AIOP_High;
+    }
+    else if (priority >= 50 || Class == EFMODFileClass::ProgrammerSound)
+    {
+        return AIOP_Normal;
+    }
+    else if (priority >= 25 || Class == EFMODFileClass::BankMetadata)
+    {
+        return AIOP_BelowNormal;
+    }
+    return AIOP_Low;
+}
+
+void FFMODFileSystem::ReleaseCompletedAsyncReads(FFMODFileHandle *FileHandle, bool bWaitForAll)
+{
+    TArray<FFMODAsyncRead *> Released;
+
+    {
+        FScopeLock lock(&FileHandle->AsyncCrit);
+
+        for (int32 i = FileHandle->AsyncReads.Num() - 1; i >= 0; --i)
+        {
+            if (FileHandle->AsyncReads[i]->Request && (bWaitForAll || FileHandle->AsyncReads[i]->bDone))
+            {
+                Released.Add(FileHandle->AsyncReads[i]);
+                FileHandle->AsyncReads.RemoveAtSwap(i, 1, false);
+            }
+        }
+    }
+
+    for (FFMODAsyncRead *Read : Released)
+    {
+        // Requests can only be deleted once their completion callback has returned
+        Read->Request->WaitCompletion();
+        delete Read->Request;
+        delete Read;
+    }
+}
+
+FMOD_RESULT F_CALLBACK FFMODFileSystem::AsyncReadCallback(FMOD_ASYNCREADINFO *info, void * /*userdata*/)
+{
+    if (!info || !info->handle)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
+
+    FFMODFileHandle *FileHandle = (FFMODFileHandle *)info->handle;
+
+    ReleaseCompletedAsyncReads(FileHandle, false);
+
+    int64 BytesLeft = FMath::Max<int64>(FileHandle->Size - (int64)info->offset, 0);
+    unsigned int ReadAmount = (unsigned int)FMath::Min((int64)info->sizebytes, BytesLeft);
+
+    // Failures are reported through done rather than the return value, so FMOD only ever sees each read finish once
+    if (ReadAmount == 0)
+    {
+        info->bytesread = 0;
+        info->done(info, FMOD_ERR_FILE_EOF);
+        return FMOD_OK;
+    }
+
+    FFMODIOTrace::RecordAccess(FileHandle->Name, info->offset, ReadAmount);
+
+    FFMODAsyncRead *Read = new FFMODAsyncRead(info, ReadAmount);
+    IAsyncReadFileHandle *AsyncHandle = nullptr;
+
+    {
+        FFMODSharedFile *Shared = FileHandle->Shared;
+        FScopeLock lock(&Shared->AsyncCrit);
+
+        if (!Shared->AsyncHandle)
+        {
+            Shared->AsyncHandle = FPlatformFileManager::Get().GetPlatformFile().OpenAsyncRead(*Shared->Name);
+        }
+        AsyncHandle = Shared->AsyncHandle;
+    }
+
+    if (AsyncHandle)
+    {
+        FScopeLock lock(&FileHandle->AsyncCrit);
+        FileHandle->AsyncReads.Add(Read);
+    }
+
+    if (!AsyncHandle)
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("FFMODFileSystem::AsyncReadCallback failed to open '%s' for async reads"), *FileHandle->Name);
+        delete Read;
+        info->bytesread = 0;
+        info->done(info, FMOD_ERR_FILE_BAD);
+        return FMOD_OK;
+    }
+
+    FAsyncFileCallBack Callback = [FileHandle, Read](bool bWasCancelled, IAsyncReadRequest *)
+    {
+        FMOD_ASYNCREADINFO *Info = Read->Info;
+        FMOD_RESULT Result = FMOD_OK;
+
+        if (bWasCancelled)
+        {
+            Info->bytesread = 0;
+            Result = FMOD_ERR_FILE_DISKEJECTED;
+        }
+        else
+        {
+            Info->bytesread = Read->SizeBytes;
+            Result = (Read->SizeBytes < Info->sizebytes) ? FMOD_ERR_FILE_EOF : FMOD_OK;
+
+            FFMODFileStats::RecordRead(FileHandle->Stats, FileHandle->StatsHandleId, Info->offset, Read->SizeBytes, Read->StartCycles, true);
+        }
+
+        {
+            FScopeLock lock(&FileHandle->AsyncCrit);
+            Read->bDone = true;
+        }
+
+        // FMOD may reuse or free the info as soon as it is told the read is done
+        Info->done(Info, Result);
+    };
+
+    // FMOD's buffer is handed straight to the request so the data lands where FMOD wants it.
+    // The callback may fire before ReadRequest returns, so the request is only published under the lock.
+    IAsyncReadRequest *Request = AsyncHandle->ReadRequest(info->offset, ReadAmount, ConvertPriority(info->priority, FileHandle->Class), &Callback, (uint8 *)info->buffer);
+
+    FEvent *PublishedEvent = nullptr;
+    bool bOwned = true;
+
+    {
+        FScopeLock lock(&FileHandle->AsyncCrit);
+        Read->Request = Request;
+        PublishedEvent = Read->PublishedEvent;
+
+        // No request means the callback will never run, so the read is failed here rather than left waiting forever
+        if (!Request)
+        {
+            Read->bDone = true;
+            bOwned = (FileHandle->AsyncReads.RemoveSingleSwap(Read, false) > 0);
+        }
+    }
+
+    if (!Request)
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("FFMODFileSystem::AsyncReadCallback failed to issue a read of '%s'"), *FileHandle->Name);
+        info->bytesread = 0;
+        info->done(info, FMOD_ERR_FILE_BAD);
+    }
+
+    // A waiting cancel has taken the read and frees it once woken, so it isn't touched after this
+    if (PublishedEvent)
+    {
+        PublishedEvent->Trigger();
+    }
+    else if (!Request && bOwned)
+    {
+        delete Read;
+    }
+
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALLBACK FFMODFileSystem::AsyncCancelCallback(FMOD_ASYNCREADINFO *info, void * /*userdata*/)
+{
+    if (!info || !info->handle)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
+
+    FFMODFileHandle *FileHandle = (FFMODFileHandle *)info->handle;
+    FFMODAsyncRead *Read = nullptr;
+    FEvent *PublishedEvent = nullptr;
+
+    {
+        FScopeLock lock(&FileHandle->AsyncCrit);
+
+        for (int32 i = 0; i < FileHandle->AsyncReads.Num(); ++i)
+        {
+            if (FileHandle->AsyncReads[i]->Info == info && !FileHandle->AsyncReads[i]->bDone)
+            {
+                Read = FileHandle->AsyncReads[i];
+                FileHandle->AsyncReads.RemoveAtSwap(i, 1, false);
+                break;
+            }
+        }
+
+        // The read is queued but AsyncReadCallback hasn't published its request yet
+        if (Read && !Read->Request)
+        {
+            PublishedEvent = FGenericPlatformProcess::GetSynchEventFromPool(true);
+            Read->PublishedEvent = PublishedEvent;
+        }
+    }
+
+    if (PublishedEvent)
+    {
+        PublishedEvent->Wait();
+        FGenericPlatformProcess::ReturnSynchEventToPool(PublishedEvent);
+    }
+
+    if (Read)
+    {
+        // FMOD requires that the read has either been cancelled or completed by the time we return
+        if (Read->Request)
+        {
+            Read->Request->Cancel();
+            Read->Request->WaitCompletion();
+            delete Read->Request;
+        }
+        delete Read;
+    }
 
     return FMOD_OK;
 }
@@ -344,3 +1113,8 @@ void AttachFMODFileSystem(FMOD::System *system, int32 fileBufferSize)
 {
     gFileSystem.Attach(system, fileBufferSize);
 }
+
+void GetFMODFileCacheStats(uint64 &hits, uint64 &misses, uint64 &bypassed)
+{
+    gFileSystem.GetCacheStats(hits, misses, bypassed);
+}
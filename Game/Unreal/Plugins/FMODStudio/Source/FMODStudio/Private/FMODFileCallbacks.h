@@ -11,3 +11,6 @@ FMOD_RESULT F_CALLBACK FMODErrorCallback(FMOD_SYSTEM *system, FMOD_SYSTEM_CALLBA
 void AcquireFMODFileSystem();
 void ReleaseFMODFileSystem();
 void AttachFMODFileSystem(FMOD::System *system, FGenericPlatformTypes::int32 fileBufferSize);
+
+// Totals for the read-ahead cache across all files since startup
+void GetFMODFileCacheStats(FGenericPlatformTypes::uint64 &hits, FGenericPlatformTypes::uint64 &misses, FGenericPlatformTypes::uint64 &bypassed);
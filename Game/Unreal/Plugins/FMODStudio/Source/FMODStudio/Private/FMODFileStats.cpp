@@ -0,0 +1,308 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODFileStats.h"
+#include "FMODFileCallbacks.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.inl"
+#include "FMODStudioPrivatePCH.h"
+
+DECLARE_STATS_GROUP(TEXT("FMOD File"), STATGROUP_FMODFile, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bytes Read"), STAT_FMODFile_BytesRead, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Reads"), STAT_FMODFile_Reads, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Opens"), STAT_FMODFile_Opens, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Seeks"), STAT_FMODFile_Seeks, STATGROUP_FMODFile);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Read Latency P50 (ms)"), STAT_FMODFile_LatencyP50, STATGROUP_FMODFile);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Read Latency P95 (ms)"), STAT_FMODFile_LatencyP95, STATGROUP_FMODFile);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Read Latency P99 (ms)"), STAT_FMODFile_LatencyP99, STATGROUP_FMODFile);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Cache Hit Rate"), STAT_FMODFile_CacheHitRate, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cache Hits"), STAT_FMODFile_CacheHits, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cache Misses"), STAT_FMODFile_CacheMisses, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cache Bypassed"), STAT_FMODFile_CacheBypassed, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Stream Near Starvation"), STAT_FMODFile_NearStarvation, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deadline Misses - Stream"), STAT_FMODFile_DeadlineMissesStream, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deadline Misses - Programmer Sound"), STAT_FMODFile_DeadlineMissesProgrammer, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deadline Misses - Bank Metadata"), STAT_FMODFile_DeadlineMissesMetadata, STATGROUP_FMODFile);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deadline Misses - Sample Data"), STAT_FMODFile_DeadlineMissesSampleData, STATGROUP_FMODFile);
+
+CSV_DEFINE_CATEGORY(FMODFile, true);
+
+UE_TRACE_CHANNEL_DEFINE(FMODFileChannel)
+
+UE_TRACE_EVENT_BEGIN(FMOD, FileOpen)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint32, HandleId)
+    UE_TRACE_EVENT_FIELD(UE::Trace::WideString, FileName)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(FMOD, FileRead)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint64, DurationCycles)
+    UE_TRACE_EVENT_FIELD(uint32, HandleId)
+    UE_TRACE_EVENT_FIELD(uint64, Offset)
+    UE_TRACE_EVENT_FIELD(uint32, Size)
+    UE_TRACE_EVENT_FIELD(bool, Async)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(FMOD, FileSeek)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint32, HandleId)
+    UE_TRACE_EVENT_FIELD(uint64, Offset)
+UE_TRACE_EVENT_END()
+
+// Percentiles published as stats cover reads completed within this window
+static const double LatencyWindowSeconds = 1.0;
+
+static FCriticalSection gStatsCrit;
+static TMap<FString, TUniquePtr<FFMODFileRecord>> gFileRecords;
+static FFMODFileRecord gTotals;
+static FFMODLatencyHistogram gLatencyWindow;
+static double gLatencyWindowStart = 0.0;
+static float gLatencyPercentiles[3] = { 0.0f, 0.0f, 0.0f };
+static uint32 gDeadlineMisses[EFMODFileClass::Max] = {};
+static uint32 gNearStarvation = 0;
+static uint32 gNextHandleId = 1;
+
+#if CSV_PROFILER
+// CSV column names per file, built on open so the per frame cost is a lookup
+static TMap<FFMODFileRecord *, FName> gCsvStatNames;
+#endif
+
+static FAutoConsoleCommand DumpFileStatsCommand(
+    TEXT("fmod.FileStats.Dump"), TEXT("Log bytes read, opens, seeks and read latency percentiles for each file opened by FMOD"),
+    FConsoleCommandDelegate::CreateStatic(&FFMODFileStats::Dump));
+
+static FAutoConsoleCommand ResetFileStatsCommand(
+    TEXT("fmod.FileStats.Reset"), TEXT("Reset FMOD file statistics"), FConsoleCommandDelegate::CreateStatic(&FFMODFileStats::Reset));
+
+FFMODLatencyHistogram::FFMODLatencyHistogram()
+{
+    Reset();
+}
+
+void FFMODLatencyHistogram::Add(uint64 Microseconds)
+{
+    int32 Bucket = (Microseconds > 1) ? (int32)FMath::FloorLog2_64(Microseconds) : 0;
+    ++Buckets[FMath::Min(Bucket, NumBuckets - 1)];
+    ++Count;
+}
+
+void FFMODLatencyHistogram::Reset()
+{
+    FMemory::Memzero(Buckets);
+    Count = 0;
+}
+
+float FFMODLatencyHistogram::GetPercentileMs(float Percentile) const
+{
+    if (Count == 0)
+    {
+        return 0.0f;
+    }
+
+    uint32 Target = FMath::Max<uint32>(1, (uint32)FMath::CeilToInt(Count * Percentile / 100.0f));
+    uint32 Seen = 0;
+
+    for (int32 i = 0; i < NumBuckets; ++i)
+    {
+        Seen += Buckets[i];
+        if (Seen >= Target)
+        {
+            return (float)(1ull << (i + 1)) / 1000.0f;
+        }
+    }
+    return (float)(1ull << NumBuckets) / 1000.0f;
+}
+
+FFMODFileRecord::FFMODFileRecord()
+    : BytesRead(0)
+    , Reads(0)
+    , Opens(0)
+    , Seeks(0)
+    , FrameBytesRead(0)
+{
+}
+
+FFMODFileRecord *FFMODFileStats::OpenFile(const FString &Name, uint32 &OutHandleId)
+{
+    FScopeLock lock(&gStatsCrit);
+
+    OutHandleId = gNextHandleId++;
+
+    UE_TRACE_LOG(FMOD, FileOpen, FMODFileChannel)
+        << FileOpen.Cycle(FPlatformTime::Cycles64())
+        << FileOpen.HandleId(OutHandleId)
+        << FileOpen.FileName(*Name, Name.Len());
+
+    TUniquePtr<FFMODFileRecord> &Record = gFileRecords.FindOrAdd(Name);
+    if (!Record.IsValid())
+    {
+        Record = MakeUnique<FFMODFileRecord>();
+#if CSV_PROFILER
+        gCsvStatNames.Add(Record.Get(), FName(*(TEXT("BytesRead_") + FPaths::GetCleanFilename(Name))));
+#endif
+    }
+
+    ++Record->Opens;
+    ++gTotals.Opens;
+
+    return Record.Get();
+}
+
+void FFMODFileStats::RecordSeek(FFMODFileRecord *Record, uint32 HandleId, uint64 Offset)
+{
+    UE_TRACE_LOG(FMOD, FileSeek, FMODFileChannel)
+        << FileSeek.Cycle(FPlatformTime::Cycles64())
+        << FileSeek.HandleId(HandleId)
+        << FileSeek.Offset(Offset);
+
+    FScopeLock lock(&gStatsCrit);
+
+    ++Record->Seeks;
+    ++gTotals.Seeks;
+}
+
+void FFMODFileStats::RecordRead(FFMODFileRecord *Record, uint32 HandleId, uint64 Offset, uint32 Bytes, uint64 StartCycles, bool bAsync)
+{
+    uint64 EndCycles = FPlatformTime::Cycles64();
+    uint64 Microseconds = (uint64)(FPlatformTime::ToSeconds64(EndCycles - StartCycles) * 1000000.0);
+
+    UE_TRACE_LOG(FMOD, FileRead, FMODFileChannel)
+        << FileRead.Cycle(StartCycles)
+        << FileRead.DurationCycles(EndCycles - StartCycles)
+        << FileRead.HandleId(HandleId)
+        << FileRead.Offset(Offset)
+        << FileRead.Size(Bytes)
+        << FileRead.Async(bAsync);
+
+    FScopeLock lock(&gStatsCrit);
+
+    Record->BytesRead += Bytes;
+    Record->FrameBytesRead += Bytes;
+    ++Record->Reads;
+    Record->Latency.Add(Microseconds);
+
+    gTotals.BytesRead += Bytes;
+    gTotals.FrameBytesRead += Bytes;
+    ++gTotals.Reads;
+    gTotals.Latency.Add(Microseconds);
+
+    gLatencyWindow.Add(Microseconds);
+}
+
+void FFMODFileStats::RecordDeadlineMiss(EFMODFileClass::Type Class)
+{
+    FScopeLock lock(&gStatsCrit);
+
+    ++gDeadlineMisses[Class];
+}
+
+void FFMODFileStats::RecordNearStarvation()
+{
+    FScopeLock lock(&gStatsCrit);
+
+    ++gNearStarvation;
+}
+
+void FFMODFileStats::Tick()
+{
+    uint64 CacheHits, CacheMisses, CacheBypassed;
+    GetFMODFileCacheStats(CacheHits, CacheMisses, CacheBypassed);
+
+    FScopeLock lock(&gStatsCrit);
+
+    double Now = FPlatformTime::Seconds();
+    if (Now - gLatencyWindowStart >= LatencyWindowSeconds)
+    {
+        gLatencyPercentiles[0] = gLatencyWindow.GetPercentileMs(50.0f);
+        gLatencyPercentiles[1] = gLatencyWindow.GetPercentileMs(95.0f);
+        gLatencyPercentiles[2] = gLatencyWindow.GetPercentileMs(99.0f);
+        gLatencyWindow.Reset();
+        gLatencyWindowStart = Now;
+    }
+
+    SET_DWORD_STAT(STAT_FMODFile_BytesRead, gTotals.FrameBytesRead);
+    SET_DWORD_STAT(STAT_FMODFile_Reads, gTotals.Reads);
+    SET_DWORD_STAT(STAT_FMODFile_Opens, gTotals.Opens);
+    SET_DWORD_STAT(STAT_FMODFile_Seeks, gTotals.Seeks);
+    SET_FLOAT_STAT(STAT_FMODFile_LatencyP50, gLatencyPercentiles[0]);
+    SET_FLOAT_STAT(STAT_FMODFile_LatencyP95, gLatencyPercentiles[1]);
+    SET_FLOAT_STAT(STAT_FMODFile_LatencyP99, gLatencyPercentiles[2]);
+    SET_FLOAT_STAT(STAT_FMODFile_CacheHitRate, (CacheHits + CacheMisses) ? 100.0f * CacheHits / (CacheHits + CacheMisses) : 0.0f);
+    SET_DWORD_STAT(STAT_FMODFile_CacheHits, CacheHits);
+    SET_DWORD_STAT(STAT_FMODFile_CacheMisses, CacheMisses);
+    SET_DWORD_STAT(STAT_FMODFile_CacheBypassed, CacheBypassed);
+    SET_DWORD_STAT(STAT_FMODFile_NearStarvation, gNearStarvation);
+    SET_DWORD_STAT(STAT_FMODFile_DeadlineMissesStream, gDeadlineMisses[EFMODFileClass::StreamRefill]);
+    SET_DWORD_STAT(STAT_FMODFile_DeadlineMissesProgrammer, gDeadlineMisses[EFMODFileClass::ProgrammerSound]);
+    SET_DWORD_STAT(STAT_FMODFile_DeadlineMissesMetadata, gDeadlineMisses[EFMODFileClass::BankMetadata]);
+    SET_DWORD_STAT(STAT_FMODFile_DeadlineMissesSampleData, gDeadlineMisses[EFMODFileClass::SampleData]);
+
+    CSV_CUSTOM_STAT(FMODFile, BytesRead, (float)gTotals.FrameBytesRead, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(FMODFile, Seeks, (int32)gTotals.Seeks, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(FMODFile, ReadLatencyP50, gLatencyPercentiles[0], ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(FMODFile, ReadLatencyP95, gLatencyPercentiles[1], ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(FMODFile, ReadLatencyP99, gLatencyPercentiles[2], ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(FMODFile, StreamNearStarvation, (int32)gNearStarvation, ECsvCustomStatOp::Set);
+    gTotals.FrameBytesRead = 0;
+
+    for (TPair<FString, TUniquePtr<FFMODFileRecord>> &Pair : gFileRecords)
+    {
+        FFMODFileRecord *Record = Pair.Value.Get();
+        if (Record->FrameBytesRead > 0)
+        {
+#if CSV_PROFILER
+            // Only files that were read this frame get a column entry, so idle banks don't pad the capture
+            FCsvProfiler::RecordCustomStat(gCsvStatNames[Record], CSV_CATEGORY_INDEX(FMODFile), (float)Record->FrameBytesRead, ECsvCustomStatOp::Set);
+#endif
+            Record->FrameBytesRead = 0;
+        }
+    }
+}
+
+void FFMODFileStats::Dump()
+{
+    FScopeLock lock(&gStatsCrit);
+
+    UE_LOG(LogFMOD, Display, TEXT("FMOD file statistics (%d files):"), gFileRecords.Num());
+
+    for (const TPair<FString, TUniquePtr<FFMODFileRecord>> &Pair : gFileRecords)
+    {
+        const FFMODFileRecord &Record = *Pair.Value;
+        UE_LOG(LogFMOD, Display, TEXT("  %s: %llu bytes in %u reads, %u opens, %u seeks, latency p50 %.2fms p95 %.2fms p99 %.2fms"),
+            *FPaths::GetCleanFilename(Pair.Key), Record.BytesRead, Record.Reads, Record.Opens, Record.Seeks,
+            Record.Latency.GetPercentileMs(50.0f), Record.Latency.GetPercentileMs(95.0f), Record.Latency.GetPercentileMs(99.0f));
+    }
+
+    UE_LOG(LogFMOD, Display, TEXT("  Total: %llu bytes in %u reads, %u opens, %u seeks, latency p50 %.2fms p95 %.2fms p99 %.2fms"),
+        gTotals.BytesRead, gTotals.Reads, gTotals.Opens, gTotals.Seeks,
+        gTotals.Latency.GetPercentileMs(50.0f), gTotals.Latency.GetPercentileMs(95.0f), gTotals.Latency.GetPercentileMs(99.0f));
+    UE_LOG(LogFMOD, Display, TEXT("  Stream near starvation: %u, deadline misses: stream %u, programmer sound %u, bank metadata %u, sample data %u"),
+        gNearStarvation, gDeadlineMisses[EFMODFileClass::StreamRefill], gDeadlineMisses[EFMODFileClass::ProgrammerSound],
+        gDeadlineMisses[EFMODFileClass::BankMetadata], gDeadlineMisses[EFMODFileClass::SampleData]);
+}
+
+void FFMODFileStats::Reset()
+{
+    FScopeLock lock(&gStatsCrit);
+
+    // Records are referenced by open handles, so clear them in place rather than removing them
+    for (TPair<FString, TUniquePtr<FFMODFileRecord>> &Pair : gFileRecords)
+    {
+        FFMODFileRecord &Record = *Pair.Value;
+        Record.BytesRead = 0;
+        Record.Reads = 0;
+        Record.Opens = 0;
+        Record.Seeks = 0;
+        Record.Latency.Reset();
+        Record.FrameBytesRead = 0;
+    }
+
+    gTotals = FFMODFileRecord();
+    gLatencyWindow.Reset();
+    FMemory::Memzero(gDeadlineMisses);
+    gNearStarvation = 0;
+}
@@ -0,0 +1,86 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+/** Insights channel carrying FMOD file reads, enable with -trace=FMODFile */
+UE_TRACE_CHANNEL_EXTERN(FMODFileChannel)
+
+/** Kinds of file access, in order of how urgently FMOD needs the data */
+namespace EFMODFileClass
+{
+enum Type
+{
+    StreamRefill,
+    ProgrammerSound,
+    BankMetadata,
+    SampleData,
+
+    Max
+};
+}
+
+/** Read latency histogram with power of two microsecond buckets */
+struct FFMODLatencyHistogram
+{
+    static const int32 NumBuckets = 24;
+
+    FFMODLatencyHistogram();
+
+    void Add(uint64 Microseconds);
+    void Reset();
+
+    /** Upper bound in milliseconds of the bucket containing the given percentile (0-100) */
+    float GetPercentileMs(float Percentile) const;
+
+    uint32 Buckets[NumBuckets];
+    uint32 Count;
+};
+
+/** File I/O totals for a single file, or for all files */
+struct FFMODFileRecord
+{
+    FFMODFileRecord();
+
+    uint64 BytesRead;
+    uint32 Reads;
+    uint32 Opens;
+    uint32 Seeks;
+    FFMODLatencyHistogram Latency;
+
+    /** Bytes read since the last call to FFMODFileStats::Tick */
+    uint64 FrameBytesRead;
+};
+
+/**
+ * Telemetry for the FMOD file callbacks.
+ * Records are kept per file for the lifetime of the module and published as stats, trace events and CSV columns.
+ */
+class FFMODFileStats
+{
+public:
+    /**
+     * Returns the record for a file, which stays valid until shutdown. OutHandleId identifies this open in the trace,
+     * which carries the file name once here rather than with every read and seek.
+     */
+    static FFMODFileRecord *OpenFile(const FString &Name, uint32 &OutHandleId);
+
+    static void RecordSeek(FFMODFileRecord *Record, uint32 HandleId, uint64 Offset);
+    static void RecordRead(FFMODFileRecord *Record, uint32 HandleId, uint64 Offset, uint32 Bytes, uint64 StartCycles, bool bAsync);
+
+    /** A request was serviced after its scheduling deadline */
+    static void RecordDeadlineMiss(EFMODFileClass::Type Class);
+
+    /** A stream refill was serviced with less than half of its deadline to spare, or FMOD asked for it urgently */
+    static void RecordNearStarvation();
+
+    /** Publish stat counters and CSV columns, once per frame on the game thread */
+    static void Tick();
+
+    /** Write per file totals and latency percentiles to the log */
+    static void Dump();
+
+    static void Reset();
+};
@@ -0,0 +1,304 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODIOTrace.h"
+#include "FMODSettings.h"
+#include "Async/Async.h"
+#include "Async/AsyncFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/UObjectGlobals.h"
+#include "FMODStudioPrivatePCH.h"
+
+#include <atomic>
+
+// Traces are kept at block granularity, so repeated reads of the same data (such as looping streams) are recorded once
+static const int64 TraceBlockSize = 64 * 1024;
+static const uint32 TraceMagic = 0x54494D46; // 'FMIT'
+static const uint32 TraceVersion = 1;
+
+// Enough requests in flight to keep the device busy without crowding out the map load
+static const int32 MaxPrefetchesInFlight = 4;
+
+// A run of consecutive blocks from one file
+struct FFMODIOTraceEntry
+{
+    int32 File;
+    uint32 FirstBlock;
+    uint32 BlockCount;
+
+    friend FArchive &operator<<(FArchive &Ar, FFMODIOTraceEntry &Entry)
+    {
+        return Ar << Entry.File << Entry.FirstBlock << Entry.BlockCount;
+    }
+};
+
+struct FFMODIOTraceData
+{
+    TArray<FString> Files;
+    TArray<FFMODIOTraceEntry> Entries;
+
+    bool Serialize(FArchive &Ar)
+    {
+        uint32 Magic = TraceMagic;
+        uint32 Version = TraceVersion;
+        Ar << Magic << Version;
+
+        if (Magic != TraceMagic || Version != TraceVersion)
+        {
+            return false;
+        }
+
+        Ar << Files << Entries;
+        return !Ar.IsError();
+    }
+};
+
+static FCriticalSection gTraceCrit;
+static std::atomic<bool> gRecording(false);
+static FString gRecordingMap;
+static FFMODIOTraceData gRecorded;
+static TMap<FString, int32> gRecordedFileIndex;
+static TSet<uint64> gRecordedBlocks;
+
+static FDelegateHandle gPreLoadMapHandle;
+static TFuture<void> gPrefetchTask;
+static std::atomic<bool> gCancelPrefetch(false);
+
+void FFMODIOTrace::Startup()
+{
+    const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+
+    if (Settings.bRecordFileAccessTraces || Settings.bPrefetchFromFileAccessTraces)
+    {
+        gPreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddStatic(&FFMODIOTrace::OnPreLoadMap);
+    }
+}
+
+void FFMODIOTrace::Shutdown()
+{
+    if (gPreLoadMapHandle.IsValid())
+    {
+        FCoreUObjectDelegates::PreLoadMap.Remove(gPreLoadMapHandle);
+        gPreLoadMapHandle.Reset();
+    }
+
+    CancelPrefetch();
+    SaveRecording();
+}
+
+void FFMODIOTrace::RecordAccess(const FString &FileName, int64 Offset, int64 Length)
+{
+    if (!gRecording || Length <= 0)
+    {
+        return;
+    }
+
+    FScopeLock lock(&gTraceCrit);
+
+    if (!gRecording)
+    {
+        return;
+    }
+
+    int32 *FileIndex = gRecordedFileIndex.Find(FileName);
+    if (!FileIndex)
+    {
+        FileIndex = &gRecordedFileIndex.Add(FileName, gRecorded.Files.Add(FileName));
+    }
+
+    uint32 FirstBlock = (uint32)(Offset / TraceBlockSize);
+    uint32 LastBlock = (uint32)((Offset + Length - 1) / TraceBlockSize);
+
+    for (uint32 Block = FirstBlock; Block <= LastBlock; ++Block)
+    {
+        bool bAlreadyRecorded = false;
+        gRecordedBlocks.Add(((uint64)*FileIndex << 32) | Block, &bAlreadyRecorded);
+        if (bAlreadyRecorded)
+        {
+            continue;
+        }
+
+        FFMODIOTraceEntry *Last = gRecorded.Entries.Num() > 0 ? &gRecorded.Entries.Last() : nullptr;
+        if (Last && Last->File == *FileIndex && Last->FirstBlock + Last->BlockCount == Block)
+        {
+            ++Last->BlockCount;
+        }
+        else
+        {
+            gRecorded.Entries.Add({ *FileIndex, Block, 1 });
+        }
+    }
+}
+
+void FFMODIOTrace::OnPreLoadMap(const FString &MapName)
+{
+    const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+
+    SaveRecording();
+    CancelPrefetch();
+
+    if (Settings.bPrefetchFromFileAccessTraces)
+    {
+        StartPrefetch(MapName);
+    }
+
+    if (Settings.bRecordFileAccessTraces)
+    {
+        FScopeLock lock(&gTraceCrit);
+
+        gRecordingMap = MapName;
+        gRecorded = FFMODIOTraceData();
+        gRecordedFileIndex.Reset();
+        gRecordedBlocks.Reset();
+        gRecording = true;
+    }
+}
+
+FString FFMODIOTrace::GetTracePath(const FString &MapName)
+{
+    return FPaths::ProjectSavedDir() / TEXT("FMOD/IOTraces") / FPackageName::GetShortName(MapName) + TEXT(".fmodiotrace");
+}
+
+void FFMODIOTrace::SaveRecording()
+{
+    FScopeLock lock(&gTraceCrit);
+
+    if (!gRecording)
+    {
+        return;
+    }
+    gRecording = false;
+
+    if (gRecorded.Entries.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    gRecorded.Serialize(Writer);
+
+    FString Path = GetTracePath(gRecordingMap);
+    if (FFileHelper::SaveArrayToFile(Bytes, *Path))
+    {
+        UE_LOG(LogFMOD, Log, TEXT("Saved FMOD I/O trace for %s: %d files, %d ranges (%s)"), *gRecordingMap, gRecorded.Files.Num(),
+            gRecorded.Entries.Num(), *Path);
+    }
+    else
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("Failed to save FMOD I/O trace to %s"), *Path);
+    }
+}
+
+void FFMODIOTrace::StartPrefetch(const FString &MapName)
+{
+    FString Path = GetTracePath(MapName);
+    TArray<uint8> Bytes;
+
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        UE_LOG(LogFMOD, Verbose, TEXT("No FMOD I/O trace for %s"), *MapName);
+        return;
+    }
+
+    FFMODIOTraceData Trace;
+    FMemoryReader Reader(Bytes);
+    if (!Trace.Serialize(Reader))
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("Ignoring FMOD I/O trace with unknown format: %s"), *Path);
+        return;
+    }
+
+    UE_LOG(LogFMOD, Log, TEXT("Prefetching %d ranges from FMOD I/O trace for %s"), Trace.Entries.Num(), *MapName);
+
+    gCancelPrefetch = false;
+    gPrefetchTask = Async(EAsyncExecution::ThreadPool, [Trace = MoveTemp(Trace)]()
+    {
+        IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        TArray<IAsyncReadFileHandle *> Handles;
+        TArray<int64> Sizes;
+        TArray<IAsyncReadRequest *> InFlight;
+
+        Handles.AddZeroed(Trace.Files.Num());
+        Sizes.Init(-1, Trace.Files.Num());
+
+        for (const FFMODIOTraceEntry &Entry : Trace.Entries)
+        {
+            if (gCancelPrefetch)
+            {
+                break;
+            }
+
+            if (!Trace.Files.IsValidIndex(Entry.File))
+            {
+                continue;
+            }
+
+            if (!Handles[Entry.File])
+            {
+                Sizes[Entry.File] = PlatformFile.FileSize(*Trace.Files[Entry.File]);
+                if (Sizes[Entry.File] <= 0)
+                {
+                    continue;
+                }
+                Handles[Entry.File] = PlatformFile.OpenAsyncRead(*Trace.Files[Entry.File]);
+                if (!Handles[Entry.File])
+                {
+                    continue;
+                }
+            }
+
+            int64 Offset = (int64)Entry.FirstBlock * TraceBlockSize;
+            int64 Length = FMath::Min((int64)Entry.BlockCount * TraceBlockSize, Sizes[Entry.File] - Offset);
+            if (Length <= 0)
+            {
+                continue;
+            }
+
+            // Keep requests issued in recorded order, with a few in flight at once
+            while (InFlight.Num() >= MaxPrefetchesInFlight)
+            {
+                InFlight[0]->WaitCompletion();
+                delete InFlight[0];
+                InFlight.RemoveAt(0, 1, false);
+            }
+
+            // The data only needs to reach the platform and pak caches, so the result is discarded
+            IAsyncReadRequest *Request = Handles[Entry.File]->ReadRequest(Offset, Length, AIOP_Low);
+            if (Request)
+            {
+                InFlight.Add(Request);
+            }
+        }
+
+        for (IAsyncReadRequest *Request : InFlight)
+        {
+            if (gCancelPrefetch)
+            {
+                Request->Cancel();
+            }
+            Request->WaitCompletion();
+            delete Request;
+        }
+
+        for (IAsyncReadFileHandle *Handle : Handles)
+        {
+            delete Handle;
+        }
+    });
+}
+
+void FFMODIOTrace::CancelPrefetch()
+{
+    if (gPrefetchTask.IsValid())
+    {
+        gCancelPrefetch = true;
+        gPrefetchTask.Wait();
+        gPrefetchTask.Reset();
+    }
+}
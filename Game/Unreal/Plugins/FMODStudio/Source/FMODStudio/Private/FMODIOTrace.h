@@ -0,0 +1,27 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Records the ranges of bank files FMOD reads while a map is played, and replays them as background
+ * prefetches the next time the map loads so the first plays after loading don't wait on the disk.
+ */
+class FFMODIOTrace
+{
+public:
+    static void Startup();
+    static void Shutdown();
+
+    /** Called by the file layer for every read serviced on behalf of FMOD */
+    static void RecordAccess(const FString &FileName, int64 Offset, int64 Length);
+
+private:
+    static void OnPreLoadMap(const FString &MapName);
+
+    static FString GetTracePath(const FString &MapName);
+    static void SaveRecording();
+    static void StartPrefetch(const FString &MapName);
+    static void CancelPrefetch();
+};
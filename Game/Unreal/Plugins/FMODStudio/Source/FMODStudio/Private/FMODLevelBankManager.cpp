@@ -0,0 +1,374 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODLevelBankManager.h"
+#include "FMODAnimNotifyPlay.h"
+#include "FMODAudioComponent.h"
+#include "FMODEvent.h"
+#include "FMODSettings.h"
+#include "FMODUtils.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "GameFramework/Actor.h"
+#include "fmod_studio.hpp"
+#include "FMODStudioPrivatePCH.h"
+
+FFMODLevelBankManager::FFMODLevelBankManager(IFMODStudioModule &InModule)
+    : Module(InModule)
+    , bRunning(false)
+    , bAcquiredAllBanks(false)
+{
+}
+
+void FFMODLevelBankManager::Start()
+{
+    if (bRunning)
+    {
+        return;
+    }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Starting level driven bank loading"));
+    bRunning = true;
+
+    LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FFMODLevelBankManager::OnLevelAdded);
+    LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FFMODLevelBankManager::OnLevelRemoved);
+    WorldInitializedActorsHandle = FWorldDelegates::OnWorldInitializedActors.AddRaw(this, &FFMODLevelBankManager::OnWorldInitializedActors);
+    WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddRaw(this, &FFMODLevelBankManager::OnWorldCleanup);
+
+    if (GEngine)
+    {
+        for (const FWorldContext &Context : GEngine->GetWorldContexts())
+        {
+            UWorld *World = Context.World();
+            if (World && World->IsGameWorld() && World->AreActorsInitialized())
+            {
+                for (ULevel *Level : World->GetLevels())
+                {
+                    if (Level && Level->bIsVisible)
+                    {
+                        AddLevel(Level);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void FFMODLevelBankManager::Stop()
+{
+    if (!bRunning)
+    {
+        return;
+    }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Stopping level driven bank loading"));
+
+    FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+    FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+    FWorldDelegates::OnWorldInitializedActors.Remove(WorldInitializedActorsHandle);
+    FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
+    TArray<ULevel *> Levels;
+    LevelEvents.GetKeys(Levels);
+    for (ULevel *Level : Levels)
+    {
+        RemoveLevel(Level);
+    }
+
+    for (const FString &BankPath : AllBanks)
+    {
+        Module.ReleaseBank(BankPath, EFMODBankOwner::Code);
+    }
+    AllBanks.Reset();
+    bAcquiredAllBanks = false;
+
+    BankHandles.Reset();
+    bRunning = false;
+}
+
+void FFMODLevelBankManager::Tick()
+{
+    if (PendingSampleData.Num() == 0)
+    {
+        return;
+    }
+
+    for (auto It = PendingSampleData.CreateIterator(); It; ++It)
+    {
+        // The event can't be found until the metadata of a bank containing it has loaded
+        if (Module.LoadEventSampleData(*It))
+        {
+            LoadedSampleData.Add(*It);
+            It.RemoveCurrent();
+            continue;
+        }
+
+        // Once its banks have loaded, an event that still can't be found isn't in them and isn't retried
+        const TArray<FString> *Banks = ReferencedBanks.Find(*It);
+        if (!IsAnyBankLoading((Banks && Banks->Num() > 0) ? *Banks : AllBanks))
+        {
+            UE_LOG(LogFMOD, Verbose, TEXT("Event %s not found in its loaded banks, not loading its sample data"),
+                *It->ToString(EGuidFormats::DigitsWithHyphensInBraces));
+            It.RemoveCurrent();
+        }
+    }
+}
+
+void FFMODLevelBankManager::AddLevelEvent(ULevel *Level, const FGuid &Event, bool bBlocking)
+{
+    if (!Level || !Event.IsValid() || !Level->OwningWorld || !Level->OwningWorld->IsGameWorld())
+    {
+        return;
+    }
+
+    // Components can register or play before their level is announced, in which case the whole level is collected now
+    if (!LevelEvents.Contains(Level))
+    {
+        AddLevel(Level);
+    }
+
+    TArray<FGuid> *Tracked = LevelEvents.Find(Level);
+    if (!Tracked)
+    {
+        return;
+    }
+
+    // Events used by spawned actors are held until the level is removed, like those of placed actors
+    if (!Tracked->Contains(Event))
+    {
+        UE_LOG(LogFMOD, Verbose, TEXT("Level %s uses FMOD event %s at runtime"), *Level->GetOutermost()->GetName(),
+            *Event.ToString(EGuidFormats::DigitsWithHyphensInBraces));
+        Tracked->Add(Event);
+        AddEventReference(Event);
+    }
+
+    const TArray<FString> *Banks = ReferencedBanks.Find(Event);
+    if (bBlocking && IsAnyBankLoading((Banks && Banks->Num() > 0) ? *Banks : AllBanks))
+    {
+        UE_LOG(LogFMOD, Verbose, TEXT("Waiting for the banks of event %s to load before playing it"),
+            *Event.ToString(EGuidFormats::DigitsWithHyphensInBraces));
+
+        // Completes every pending non-blocking bank load, not only this event's
+        verifyfmod(Module.GetStudioSystem(EFMODSystemContext::Runtime)->flushCommands());
+    }
+}
+
+void FFMODLevelBankManager::OnLevelAdded(ULevel *Level, UWorld *World)
+{
+    if (World && World->IsGameWorld())
+    {
+        AddLevel(Level);
+    }
+}
+
+void FFMODLevelBankManager::OnLevelRemoved(ULevel *Level, UWorld *World)
+{
+    // A null level means every level in the world is being removed
+    if (Level)
+    {
+        RemoveLevel(Level);
+    }
+    else if (World)
+    {
+        OnWorldCleanup(World, false, false);
+    }
+}
+
+void FFMODLevelBankManager::OnWorldInitializedActors(const UWorld::FActorsInitializedParams &Params)
+{
+    // The persistent level isn't announced through LevelAddedToWorld
+    if (Params.World && Params.World->IsGameWorld())
+    {
+        AddLevel(Params.World->PersistentLevel);
+    }
+}
+
+void FFMODLevelBankManager::OnWorldCleanup(UWorld *World, bool bSessionEnded, bool bCleanupResources)
+{
+    TArray<ULevel *> Levels;
+    for (const TPair<ULevel *, TArray<FGuid>> &Pair : LevelEvents)
+    {
+        if (Pair.Key->OwningWorld == World)
+        {
+            Levels.Add(Pair.Key);
+        }
+    }
+
+    for (ULevel *Level : Levels)
+    {
+        RemoveLevel(Level);
+    }
+}
+
+void FFMODLevelBankManager::AddLevel(ULevel *Level)
+{
+    if (!Level || LevelEvents.Contains(Level) || !Module.GetStudioSystem(EFMODSystemContext::Runtime))
+    {
+        return;
+    }
+
+    TSet<FGuid> Events;
+    CollectEvents(Level, Events);
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Level %s references %d FMOD events"), *Level->GetOutermost()->GetName(), Events.Num());
+
+    TArray<FGuid> &Tracked = LevelEvents.Add(Level);
+    for (const FGuid &Event : Events)
+    {
+        Tracked.Add(Event);
+        AddEventReference(Event);
+    }
+}
+
+void FFMODLevelBankManager::RemoveLevel(ULevel *Level)
+{
+    TArray<FGuid> Events;
+    if (!LevelEvents.RemoveAndCopyValue(Level, Events))
+    {
+        return;
+    }
+
+    for (const FGuid &Event : Events)
+    {
+        RemoveEventReference(Event);
+    }
+}
+
+void FFMODLevelBankManager::CollectEvents(ULevel *Level, TSet<FGuid> &Events) const
+{
+    for (AActor *Actor : Level->Actors)
+    {
+        if (!IsValid(Actor))
+        {
+            continue;
+        }
+
+        // Covers ambient sound actors as well as audio components added to any other actor
+        TInlineComponentArray<UFMODAudioComponent *> AudioComponents(Actor);
+        for (UFMODAudioComponent *Component : AudioComponents)
+        {
+            if (IsValid(Component->Event))
+            {
+                Events.Add(Component->Event->AssetGuid);
+            }
+        }
+
+        // Notifies are only discoverable on animations assigned directly; animation blueprints are not traversed
+        TInlineComponentArray<USkeletalMeshComponent *> MeshComponents(Actor);
+        for (USkeletalMeshComponent *Component : MeshComponents)
+        {
+            CollectNotifyEvents(Cast<UAnimSequenceBase>(Component->AnimationData.AnimToPlay), Events);
+        }
+    }
+}
+
+void FFMODLevelBankManager::CollectNotifyEvents(const UAnimSequenceBase *Animation, TSet<FGuid> &Events) const
+{
+    if (!Animation)
+    {
+        return;
+    }
+
+    for (const FAnimNotifyEvent &NotifyEvent : Animation->Notifies)
+    {
+        const UFMODAnimNotifyPlay *Notify = Cast<UFMODAnimNotifyPlay>(NotifyEvent.Notify);
+        if (Notify && IsValid(Notify->Event))
+        {
+            Events.Add(Notify->Event->AssetGuid);
+        }
+    }
+}
+
+void FFMODLevelBankManager::GetEventBanks(const FGuid &Event, TArray<FString> &Banks)
+{
+    // Without event dependencies there is no way to tell which banks a level needs, short of loading them all
+    if (!Module.GetEventBankPaths(Event, Banks) && !bAcquiredAllBanks)
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("The bank lookup has no event dependencies, so all banks are loaded instead of per level. Rebuild the FMOD banks to generate them"));
+        AcquireAllBanks();
+    }
+}
+
+void FFMODLevelBankManager::AcquireAllBanks()
+{
+    bAcquiredAllBanks = true;
+    Module.GetAllBankPaths(AllBanks, false);
+
+    for (const FString &BankPath : AllBanks)
+    {
+        AcquireBank(BankPath);
+    }
+}
+
+void FFMODLevelBankManager::AcquireBank(const FString &BankPath)
+{
+    if (FMOD::Studio::Bank *Bank = Module.AcquireBank(BankPath, false, EFMODBankOwner::Code))
+    {
+        BankHandles.Add(BankPath, Bank);
+    }
+}
+
+bool FFMODLevelBankManager::IsAnyBankLoading(const TArray<FString> &BankPaths) const
+{
+    for (const FString &BankPath : BankPaths)
+    {
+        FMOD::Studio::Bank *const *Bank = BankHandles.Find(BankPath);
+        FMOD_STUDIO_LOADING_STATE State = FMOD_STUDIO_LOADING_STATE_ERROR;
+        if (Bank && (*Bank)->getLoadingState(&State) == FMOD_OK && State == FMOD_STUDIO_LOADING_STATE_LOADING)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FFMODLevelBankManager::AddEventReference(const FGuid &Event)
+{
+    if (++EventRefs.FindOrAdd(Event) > 1)
+    {
+        return;
+    }
+
+    TArray<FString> &Banks = ReferencedBanks.Add(Event);
+    GetEventBanks(Event, Banks);
+
+    if (Banks.Num() == 0 && !bAcquiredAllBanks)
+    {
+        UE_LOG(LogFMOD, Verbose, TEXT("No bank found for event %s"), *Event.ToString(EGuidFormats::DigitsWithHyphensInBraces));
+    }
+
+    for (const FString &BankPath : Banks)
+    {
+        AcquireBank(BankPath);
+    }
+
+    if (GetDefault<UFMODSettings>()->bLoadLevelEventSampleData)
+    {
+        PendingSampleData.Add(Event);
+    }
+}
+
+void FFMODLevelBankManager::RemoveEventReference(const FGuid &Event)
+{
+    int32 *Refs = EventRefs.Find(Event);
+    if (!Refs || --(*Refs) > 0)
+    {
+        return;
+    }
+    EventRefs.Remove(Event);
+    PendingSampleData.Remove(Event);
+
+    if (LoadedSampleData.Remove(Event) > 0)
+    {
+        Module.UnloadEventSampleData(Event);
+    }
+
+    TArray<FString> Banks;
+    ReferencedBanks.RemoveAndCopyValue(Event, Banks);
+
+    for (const FString &BankPath : Banks)
+    {
+        Module.ReleaseBank(BankPath, EFMODBankOwner::Code);
+    }
+}
@@ -0,0 +1,84 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "FMODStudioModule.h"
+
+class ULevel;
+class UAnimSequenceBase;
+
+/**
+ * Loads banks, and optionally event sample data, for the FMOD events referenced by the levels currently in game worlds.
+ * Each event referenced by a level holds a reference on its banks, which are released when the last of those levels is removed.
+ * Events are collected from the actors placed in a level when it is added, and from audio components spawned into it
+ * later as they register or play.
+ */
+class FFMODLevelBankManager
+{
+public:
+    FFMODLevelBankManager(IFMODStudioModule &InModule);
+
+    /** Start tracking levels for the runtime system, picking up any levels already loaded */
+    void Start();
+
+    /** Stop tracking levels and unload everything the manager loaded */
+    void Stop();
+
+    /** Load sample data for events whose banks have finished loading */
+    void Tick();
+
+    /** Hold the banks for an event used by a component in a level, optionally waiting for them to finish loading */
+    void AddLevelEvent(ULevel *Level, const FGuid &Event, bool bBlocking);
+
+    bool IsRunning() const { return bRunning; }
+
+private:
+    void OnLevelAdded(ULevel *Level, UWorld *World);
+    void OnLevelRemoved(ULevel *Level, UWorld *World);
+    void OnWorldInitializedActors(const UWorld::FActorsInitializedParams &Params);
+    void OnWorldCleanup(UWorld *World, bool bSessionEnded, bool bCleanupResources);
+
+    void AddLevel(ULevel *Level);
+    void RemoveLevel(ULevel *Level);
+
+    void CollectEvents(ULevel *Level, TSet<FGuid> &Events) const;
+    void CollectNotifyEvents(const UAnimSequenceBase *Animation, TSet<FGuid> &Events) const;
+
+    void GetEventBanks(const FGuid &Event, TArray<FString> &Banks);
+    void AcquireAllBanks();
+    void AcquireBank(const FString &BankPath);
+    bool IsAnyBankLoading(const TArray<FString> &BankPaths) const;
+
+    void AddEventReference(const FGuid &Event);
+    void RemoveEventReference(const FGuid &Event);
+
+    IFMODStudioModule &Module;
+    bool bRunning;
+
+    /** Every bank, held while running when the bank lookup has no event dependencies to choose banks from */
+    TArray<FString> AllBanks;
+    bool bAcquiredAllBanks;
+
+    /** Handles returned when acquiring banks, used to tell when a bank has finished loading */
+    TMap<FString, FMOD::Studio::Bank *> BankHandles;
+
+    /** Banks acquired for each referenced event */
+    TMap<FGuid, TArray<FString>> ReferencedBanks;
+
+    /** Events referenced by each tracked level */
+    TMap<ULevel *, TArray<FGuid>> LevelEvents;
+
+    /** Number of tracked levels referencing each event */
+    TMap<FGuid, int32> EventRefs;
+
+    /** Events waiting for their banks to load before their sample data can be loaded, and those with sample data loaded */
+    TSet<FGuid> PendingSampleData;
+    TSet<FGuid> LoadedSampleData;
+
+    FDelegateHandle LevelAddedHandle;
+    FDelegateHandle LevelRemovedHandle;
+    FDelegateHandle WorldInitializedActorsHandle;
+    FDelegateHandle WorldCleanupHandle;
+};
@@ -0,0 +1,314 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODLocaleSwap.h"
+#include "FMODBankResidency.h"
+#include "FMODSampleDataBudget.h"
+#include "FMODSettings.h"
+#include "FMODUtils.h"
+#include "Async/Async.h"
+#include "Async/AsyncFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "fmod_studio.hpp"
+#include "fmod_errors.h"
+#include "FMODStudioPrivatePCH.h"
+
+static const int64 PrefetchChunkSize = 1024 * 1024;
+static const int32 MaxPrefetchesInFlight = 4;
+
+FFMODLocaleSwap::FFMODLocaleSwap(IFMODStudioModule &InModule, FFMODBankResidency &InBankResidency, FFMODSampleDataBudget &InSampleDataBudget)
+    : Module(InModule)
+    , BankResidency(InBankResidency)
+    , SampleDataBudget(InSampleDataBudget)
+{
+}
+
+void FFMODLocaleSwap::Begin(const TMap<FGuid, FString> &OldPaths, const TMap<FGuid, FString> &NewPaths)
+{
+    FMOD::Studio::System *System = Module.GetStudioSystem(EFMODSystemContext::Runtime);
+    if (!System)
+    {
+        return;
+    }
+
+    for (const TPair<FGuid, FString> &Pair : NewPaths)
+    {
+        const FString *OldPath = OldPaths.Find(Pair.Key);
+        if (!OldPath || *OldPath == Pair.Value)
+        {
+            continue;
+        }
+
+        if (FJob *Job = Jobs.Find(Pair.Key))
+        {
+            if (Job->State == EState::Loading)
+            {
+                Job->PendingPath = Pair.Value;
+                continue;
+            }
+
+            // The old bank is still loaded, so the swap is retargeted or, if switching straight back, dropped
+            CancelPrefetch(*Job);
+            Job->NewPath = Pair.Value;
+            if (Job->NewPath == Job->OldPath)
+            {
+                Jobs.Remove(Pair.Key);
+            }
+            else
+            {
+                Job->State = EState::Prefetching;
+                StartPrefetch(*Job);
+            }
+            continue;
+        }
+
+        // Banks that aren't loaded are picked up from the new locale's paths the next time they are
+        FMOD::Studio::ID Guid = FMODUtils::ConvertGuid(Pair.Key);
+        FMOD::Studio::Bank *Bank = nullptr;
+        if (System->getBankByID(&Guid, &Bank) != FMOD_OK || !Bank)
+        {
+            continue;
+        }
+
+        FJob &Job = Jobs.Add(Pair.Key);
+        Job.OldPath = *OldPath;
+        Job.NewPath = Pair.Value;
+        Job.OldBank = Bank;
+        StartPrefetch(Job);
+    }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Swapping %d localized banks"), Jobs.Num());
+}
+
+void FFMODLocaleSwap::Tick()
+{
+    double Now = FPlatformTime::Seconds();
+    double MaxDrainTime = GetDefault<UFMODSettings>()->LocaleSwapDrainTime;
+
+    for (auto It = Jobs.CreateIterator(); It; ++It)
+    {
+        FJob &Job = It.Value();
+
+        if (Job.State == EState::Prefetching)
+        {
+            if (Job.Prefetch.IsValid() && !Job.Prefetch.IsReady())
+            {
+                continue;
+            }
+            Job.State = EState::Draining;
+            Job.DrainStartTime = Now;
+        }
+
+        if (Job.State == EState::Draining)
+        {
+            if (HasPlayingInstances(Job.OldBank) && Now - Job.DrainStartTime < MaxDrainTime)
+            {
+                continue;
+            }
+            Job.State = EState::Swapping;
+        }
+
+        if (Job.State == EState::Swapping)
+        {
+            // The old bank was unloaded by its owner while waiting, so the new locale's version is loaded on demand
+            if (Job.OldBank && !Job.OldBank->isValid())
+            {
+                It.RemoveCurrent();
+                continue;
+            }
+
+            if (!Swap(Job))
+            {
+                continue;
+            }
+        }
+
+        if (Job.State == EState::Loading && FinishLoad(Job))
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+void FFMODLocaleSwap::Reset()
+{
+    for (TPair<FGuid, FJob> &Pair : Jobs)
+    {
+        CancelPrefetch(Pair.Value);
+    }
+    Jobs.Reset();
+}
+
+void FFMODLocaleSwap::StartPrefetch(FJob &Job)
+{
+    FString Path = Job.NewPath;
+    TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> Cancel = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+    Job.CancelPrefetch = Cancel;
+
+    // The data only needs to reach the platform and pak caches, so the results are discarded
+    Job.Prefetch = Async(EAsyncExecution::ThreadPool, [Path, Cancel]()
+    {
+        IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        int64 Size = PlatformFile.FileSize(*Path);
+        TUniquePtr<IAsyncReadFileHandle> Handle(Size > 0 ? PlatformFile.OpenAsyncRead(*Path) : nullptr);
+        if (!Handle)
+        {
+            return;
+        }
+
+        TArray<IAsyncReadRequest *> InFlight;
+        for (int64 Offset = 0; Offset < Size && !*Cancel; Offset += PrefetchChunkSize)
+        {
+            while (InFlight.Num() >= MaxPrefetchesInFlight)
+            {
+                InFlight[0]->WaitCompletion();
+                delete InFlight[0];
+                InFlight.RemoveAt(0, 1, false);
+            }
+
+            IAsyncReadRequest *Request = Handle->ReadRequest(Offset, FMath::Min(PrefetchChunkSize, Size - Offset), AIOP_Low);
+            if (Request)
+            {
+                InFlight.Add(Request);
+            }
+        }
+
+        for (IAsyncReadRequest *Request : InFlight)
+        {
+            if (*Cancel)
+            {
+                Request->Cancel();
+            }
+            Request->WaitCompletion();
+            delete Request;
+        }
+    });
+}
+
+void FFMODLocaleSwap::CancelPrefetch(FJob &Job)
+{
+    if (Job.Prefetch.IsValid())
+    {
+        *Job.CancelPrefetch = true;
+        Job.Prefetch.Wait();
+        Job.Prefetch.Reset();
+    }
+}
+
+bool FFMODLocaleSwap::HasPlayingInstances(FMOD::Studio::Bank *Bank) const
+{
+    int Count = 0;
+    if (!Bank->isValid() || Bank->getEventCount(&Count) != FMOD_OK || Count == 0)
+    {
+        return false;
+    }
+
+    TArray<FMOD::Studio::EventDescription *> Events;
+    Events.AddZeroed(Count);
+    Bank->getEventList(Events.GetData(), Count, &Count);
+
+    for (int i = 0; i < Count; ++i)
+    {
+        int Instances = 0;
+        if (Events[i]->getInstanceCount(&Instances) == FMOD_OK && Instances > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FFMODLocaleSwap::Swap(FJob &Job)
+{
+    if (Job.OldBank)
+    {
+        // Unloading the bank frees its sample data, so the budget forgets it rather than unloading it
+        Job.BankSampleDataRefs = SampleDataBudget.SuspendBank(Job.OldPath) + SampleDataBudget.SuspendBank(Job.NewPath);
+        SampleDataBudget.SuspendEvents(Job.OldBank, Job.EventSampleDataRefs);
+
+        UE_LOG(LogFMOD, Verbose, TEXT("Swapping bank %s for %s"), *Job.OldPath, *Job.NewPath);
+        Module.UnloadBank(EFMODSystemContext::Runtime, Job.OldBank);
+        Job.UnloadingBank = Job.OldBank;
+        Job.OldBank = nullptr;
+    }
+
+    // Each attempt opens, and may map, the new bank file, so nothing is tried until the old bank has gone
+    if (Job.UnloadingBank && Job.UnloadingBank->isValid())
+    {
+        FMOD_STUDIO_LOADING_STATE State = FMOD_STUDIO_LOADING_STATE_ERROR;
+        if (Job.UnloadingBank->getLoadingState(&State) == FMOD_OK && State != FMOD_STUDIO_LOADING_STATE_UNLOADED)
+        {
+            return false;
+        }
+    }
+
+    FMOD::Studio::Bank *Bank = nullptr;
+    FMOD_RESULT Result = Module.LoadBankFile(EFMODSystemContext::Runtime, Job.NewPath, FMOD_STUDIO_LOAD_BANK_NONBLOCKING, &Bank);
+
+    // The old bank's events can still be releasing after it reports unloaded, in which case the load is tried again
+    if (Result == FMOD_ERR_EVENT_ALREADY_LOADED)
+    {
+        return false;
+    }
+    Job.UnloadingBank = nullptr;
+
+    if (Result != FMOD_OK || !Bank)
+    {
+        UE_LOG(LogFMOD, Error, TEXT("Failed to load bank %s: %s"), *Job.NewPath, UTF8_TO_TCHAR(FMOD_ErrorString(Result)));
+        BankResidency.SwapBank(Job.OldPath, Job.NewPath, nullptr);
+        Job.State = EState::Loading;
+        return true;
+    }
+
+    // Residency loads sample data for its own references once the bank has loaded
+    if (BankResidency.SwapBank(Job.OldPath, Job.NewPath, Bank))
+    {
+        Job.BankSampleDataRefs = FMath::Max(0, Job.BankSampleDataRefs - 1);
+    }
+
+    Job.NewBank = Bank;
+    Job.State = EState::Loading;
+    return true;
+}
+
+bool FFMODLocaleSwap::FinishLoad(FJob &Job)
+{
+    if (Job.NewBank)
+    {
+        FMOD_STUDIO_LOADING_STATE State = FMOD_STUDIO_LOADING_STATE_ERROR;
+        Job.NewBank->getLoadingState(&State);
+        if (State == FMOD_STUDIO_LOADING_STATE_LOADING)
+        {
+            return false;
+        }
+
+        if (State == FMOD_STUDIO_LOADING_STATE_LOADED)
+        {
+            for (int32 i = 0; i < Job.BankSampleDataRefs; ++i)
+            {
+                SampleDataBudget.LoadBank(Job.NewPath, Job.NewBank);
+            }
+            SampleDataBudget.ResumeEvents(Job.NewBank, Job.EventSampleDataRefs);
+
+            UE_LOG(LogFMOD, Log, TEXT("Swapped localized bank %s"), *Job.NewPath);
+        }
+        else
+        {
+            UE_LOG(LogFMOD, Error, TEXT("Failed to load localized bank %s"), *Job.NewPath);
+        }
+    }
+
+    // The locale changed again while this swap was loading, so it is followed by another from the bank just loaded
+    if (!Job.PendingPath.IsEmpty() && Job.PendingPath != Job.NewPath && Job.NewBank && Job.NewBank->isValid())
+    {
+        FJob Next;
+        Next.OldPath = Job.NewPath;
+        Next.NewPath = Job.PendingPath;
+        Next.OldBank = Job.NewBank;
+
+        Job = MoveTemp(Next);
+        StartPrefetch(Job);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,94 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeBool.h"
+#include "FMODStudioModule.h"
+
+class FFMODBankResidency;
+class FFMODSampleDataBudget;
+
+/**
+ * Swaps the loaded runtime banks for another locale without blocking the game thread.
+ *
+ * Every locale's version of a localized bank shares the same GUID, so FMOD can't hold two of them at once. Each swap
+ * instead reads the new bank file in the background to warm the file caches, waits for instances of the old bank's
+ * events to finish, then unloads the old bank and loads the new one without blocking. Event starts keep using the old
+ * bank until it is swapped. Sample data loaded for the old bank or its events is loaded again for the new one.
+ */
+class FFMODLocaleSwap
+{
+public:
+    FFMODLocaleSwap(IFMODStudioModule &InModule, FFMODBankResidency &InBankResidency, FFMODSampleDataBudget &InSampleDataBudget);
+
+    /** Start swapping every loaded bank whose path differs between the old and new locale, given full paths by bank GUID */
+    void Begin(const TMap<FGuid, FString> &OldPaths, const TMap<FGuid, FString> &NewPaths);
+
+    /** Advance the swaps, called once startup bank loading has finished */
+    void Tick();
+
+    /** Abandon all swaps immediately, called before the runtime system is destroyed */
+    void Reset();
+
+    bool IsInProgress() const { return Jobs.Num() > 0; }
+
+private:
+    enum class EState
+    {
+        Prefetching,
+        Draining,
+        Swapping,
+        Loading,
+    };
+
+    struct FJob
+    {
+        FJob()
+            : State(EState::Prefetching)
+            , OldBank(nullptr)
+            , NewBank(nullptr)
+            , UnloadingBank(nullptr)
+            , DrainStartTime(0.0)
+            , BankSampleDataRefs(0)
+        {
+        }
+
+        EState State;
+        FString OldPath;
+        FString NewPath;
+
+        /** Set when the locale changes again after this swap has started loading its new bank */
+        FString PendingPath;
+
+        FMOD::Studio::Bank *OldBank;
+        FMOD::Studio::Bank *NewBank;
+
+        /** The old bank once its unload has been requested, polled until the new bank can be loaded */
+        FMOD::Studio::Bank *UnloadingBank;
+
+        TFuture<void> Prefetch;
+        TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> CancelPrefetch;
+
+        double DrainStartTime;
+
+        /** Sample data references held on the old bank and its events, restored once the new bank has loaded */
+        int32 BankSampleDataRefs;
+        TMap<FGuid, int32> EventSampleDataRefs;
+    };
+
+    void StartPrefetch(FJob &Job);
+    void CancelPrefetch(FJob &Job);
+
+    bool HasPlayingInstances(FMOD::Studio::Bank *Bank) const;
+    bool Swap(FJob &Job);
+    bool FinishLoad(FJob &Job);
+
+    IFMODStudioModule &Module;
+    FFMODBankResidency &BankResidency;
+    FFMODSampleDataBudget &SampleDataBudget;
+
+    /** Swaps in progress by bank GUID */
+    TMap<FGuid, FJob> Jobs;
+};
@@ -0,0 +1,21 @@
+// Copyright (c), Firelight Technologies Pty, Ltd.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "FMODMapManifest.generated.h"
+
+USTRUCT()
+struct FMODSTUDIO_API FFMODMapManifestRow : public FTableRowBase
+{
+    GENERATED_BODY()
+
+    /** GUIDs of the events the map can play, found from everything the map package depends on */
+    UPROPERTY(VisibleAnywhere, Category="FMOD|Internal|MapManifest")
+    TArray<FGuid> Events;
+
+    /** GUIDs of the banks those events need, taken from the event dependencies in the bank lookup */
+    UPROPERTY(VisibleAnywhere, Category="FMOD|Internal|MapManifest")
+    TArray<FGuid> Banks;
+};
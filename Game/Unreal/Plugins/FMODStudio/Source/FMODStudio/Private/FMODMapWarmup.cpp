@@ -0,0 +1,281 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODMapWarmup.h"
+#include "FMODAssetTable.h"
+#include "FMODUtils.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+#include "fmod_studio.hpp"
+#include "FMODStudioPrivatePCH.h"
+
+FFMODMapWarmup::FFMODMapWarmup(IFMODStudioModule &InModule, const FFMODAssetTable &InAssetTable)
+    : Module(InModule)
+    , AssetTable(InAssetTable)
+    , bRunning(false)
+    , Progress(1.0f)
+    , ReportCommand(nullptr)
+{
+}
+
+void FFMODMapWarmup::Start()
+{
+    if (bRunning)
+    {
+        return;
+    }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Starting map audio warm-up"));
+    bRunning = true;
+
+    PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddRaw(this, &FFMODMapWarmup::OnPreLoadMap);
+    ReportCommand = IConsoleManager::Get().RegisterConsoleCommand(TEXT("fmod.Warmup.Report"),
+        TEXT("Log the FMOD events played in the current map before their sample data was loaded"),
+        FConsoleCommandDelegate::CreateRaw(this, &FFMODMapWarmup::ReportColdPlays), ECVF_Default);
+
+    // Banks may finish loading after the first map, which is then warmed up late rather than not at all
+    if (GEngine)
+    {
+        for (const FWorldContext &Context : GEngine->GetWorldContexts())
+        {
+            UWorld *World = Context.World();
+            if (World && World->IsGameWorld())
+            {
+                Begin(World->GetOutermost()->GetName());
+                break;
+            }
+        }
+    }
+}
+
+void FFMODMapWarmup::Stop()
+{
+    if (!bRunning)
+    {
+        return;
+    }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Stopping map audio warm-up"));
+
+    FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+    if (ReportCommand)
+    {
+        IConsoleManager::Get().UnregisterConsoleObject(ReportCommand);
+        ReportCommand = nullptr;
+    }
+
+    ReportColdPlays();
+    ColdPlays.Reset();
+
+    Release(Current);
+    Progress = 1.0f;
+    bRunning = false;
+}
+
+void FFMODMapWarmup::Tick()
+{
+    if (Current.PendingSampleData.Num() > 0)
+    {
+        // Checked before trying the events, so a failure with no banks loading means the event isn't in them
+        bool bBanksLoading = IsBankLoading(Current);
+
+        for (auto It = Current.PendingSampleData.CreateIterator(); It; ++It)
+        {
+            // The event can't be found until the metadata of a bank containing it has loaded
+            if (Module.LoadEventSampleData(*It))
+            {
+                Current.LoadedSampleData.Add(*It);
+                It.RemoveCurrent();
+            }
+            else if (!bBanksLoading)
+            {
+                Current.MissingEvents.Add(*It);
+                It.RemoveCurrent();
+            }
+        }
+    }
+
+    if (Progress < 1.0f)
+    {
+        UpdateProgress();
+    }
+}
+
+void FFMODMapWarmup::RecordPlay(FMOD::Studio::EventDescription *EventDesc)
+{
+    if (!bRunning || !EventDesc)
+    {
+        return;
+    }
+
+    FMOD_STUDIO_LOADING_STATE State = FMOD_STUDIO_LOADING_STATE_ERROR;
+    if (EventDesc->getSampleLoadingState(&State) != FMOD_OK || State == FMOD_STUDIO_LOADING_STATE_LOADED)
+    {
+        return;
+    }
+
+    FMOD::Studio::ID Id;
+    if (EventDesc->getID(&Id) != FMOD_OK)
+    {
+        return;
+    }
+
+    FGuid Guid = FMODUtils::ConvertGuid(Id);
+    FColdPlay &Play = ColdPlays.FindOrAdd(Guid);
+    if (Play.Count++ == 0)
+    {
+        Play.Path = FMODUtils::GetPath(EventDesc);
+        Play.bInManifest = Current.Events.Contains(Guid);
+        UE_LOG(LogFMOD, Verbose, TEXT("Event %s played before its sample data was loaded"), *Play.Path);
+    }
+}
+
+void FFMODMapWarmup::OnPreLoadMap(const FString &MapName)
+{
+    ReportColdPlays();
+    ColdPlays.Reset();
+
+    Begin(MapName);
+}
+
+void FFMODMapWarmup::Begin(const FString &MapName)
+{
+    FMapState Next;
+    Next.MapName = UWorld::RemovePIEPrefix(MapName);
+    Next.StartTime = FPlatformTime::Seconds();
+
+    TArray<FString> BankPaths;
+    if (AssetTable.GetMapManifest(Next.MapName, Next.Events, BankPaths))
+    {
+        UE_LOG(LogFMOD, Log, TEXT("Warming up %d FMOD events in %d banks for %s"), Next.Events.Num(), BankPaths.Num(), *Next.MapName);
+
+        for (const FString &BankPath : BankPaths)
+        {
+            if (FMOD::Studio::Bank *Bank = Module.AcquireBank(BankPath, false, EFMODBankOwner::Code))
+            {
+                Next.Banks.Add(BankPath, Bank);
+            }
+        }
+        Next.PendingSampleData.Append(Next.Events);
+
+        // Events used by both maps take a reference for the next map before the current map's are released, so their
+        // sample data stays loaded instead of being unloaded and loaded again a tick later
+        for (const FGuid &Event : Next.Events)
+        {
+            if (Current.LoadedSampleData.Contains(Event) && Module.LoadEventSampleData(Event))
+            {
+                Next.LoadedSampleData.Add(Event);
+                Next.PendingSampleData.Remove(Event);
+            }
+        }
+    }
+    else
+    {
+        UE_LOG(LogFMOD, Verbose, TEXT("No FMOD map manifest for %s"), *Next.MapName);
+    }
+
+    // The next map's references are taken first so banks and sample data used by both maps are never unloaded
+    Release(Current);
+    Current = MoveTemp(Next);
+    Progress = (Current.Events.Num() > 0) ? 0.0f : 1.0f;
+}
+
+void FFMODMapWarmup::Release(FMapState &State)
+{
+    for (const FGuid &Event : State.LoadedSampleData)
+    {
+        Module.UnloadEventSampleData(Event);
+    }
+
+    for (const TPair<FString, FMOD::Studio::Bank *> &Pair : State.Banks)
+    {
+        Module.ReleaseBank(Pair.Key, EFMODBankOwner::Code);
+    }
+
+    State = FMapState();
+}
+
+bool FFMODMapWarmup::IsBankLoading(const FMapState &State) const
+{
+    for (const TPair<FString, FMOD::Studio::Bank *> &Pair : State.Banks)
+    {
+        FMOD_STUDIO_LOADING_STATE BankState = FMOD_STUDIO_LOADING_STATE_ERROR;
+        if (Pair.Value->getLoadingState(&BankState) == FMOD_OK && BankState == FMOD_STUDIO_LOADING_STATE_LOADING)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FFMODMapWarmup::IsEventSettled(FMOD::Studio::System *System, const FGuid &Event, bool bBanksLoading) const
+{
+    // An event still missing once every bank has loaded isn't in them, so there is nothing more to wait for
+    FMOD::Studio::ID Guid = FMODUtils::ConvertGuid(Event);
+    FMOD::Studio::EventDescription *EventDesc = nullptr;
+    if (Current.MissingEvents.Contains(Event))
+    {
+        return true;
+    }
+    if (Current.PendingSampleData.Contains(Event) || System->getEventByID(&Guid, &EventDesc) != FMOD_OK || !EventDesc)
+    {
+        return !bBanksLoading;
+    }
+
+    FMOD_STUDIO_LOADING_STATE State = FMOD_STUDIO_LOADING_STATE_ERROR;
+    EventDesc->getSampleLoadingState(&State);
+    return State == FMOD_STUDIO_LOADING_STATE_LOADED || State == FMOD_STUDIO_LOADING_STATE_ERROR;
+}
+
+void FFMODMapWarmup::UpdateProgress()
+{
+    FMOD::Studio::System *System = Module.GetStudioSystem(EFMODSystemContext::Runtime);
+    if (!System)
+    {
+        return;
+    }
+
+    bool bBanksLoading = IsBankLoading(Current);
+    int32 Settled = 0;
+    for (const FGuid &Event : Current.Events)
+    {
+        Settled += IsEventSettled(System, Event, bBanksLoading) ? 1 : 0;
+    }
+
+    if (Settled < Current.Events.Num())
+    {
+        Progress = (float)Settled / Current.Events.Num();
+        return;
+    }
+
+    Progress = 1.0f;
+    UE_LOG(LogFMOD, Log, TEXT("FMOD audio for %s warmed up in %.2fs"), *Current.MapName, FPlatformTime::Seconds() - Current.StartTime);
+
+    int32 MissingCount = Current.MissingEvents.Num() + Current.PendingSampleData.Num();
+    if (MissingCount > 0)
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("%d events in the manifest for %s are not in its banks, regenerate the FMOD map manifests"),
+            MissingCount, *Current.MapName);
+    }
+}
+
+void FFMODMapWarmup::ReportColdPlays() const
+{
+    if (ColdPlays.Num() == 0)
+    {
+        if (!Current.MapName.IsEmpty())
+        {
+            UE_LOG(LogFMOD, Log, TEXT("No FMOD events played cold in %s"), *Current.MapName);
+        }
+        return;
+    }
+
+    UE_LOG(LogFMOD, Warning, TEXT("%d FMOD events played in %s before their sample data was loaded"), ColdPlays.Num(), *Current.MapName);
+
+    for (const TPair<FGuid, FColdPlay> &Pair : ColdPlays)
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("  %s: %d plays%s"), *Pair.Value.Path, Pair.Value.Count,
+            Pair.Value.bInManifest ? TEXT("") : TEXT(", not in the map manifest"));
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FMODStudioModule.h"
+
+class FFMODAssetTable;
+class IConsoleObject;
+
+/**
+ * Warms up the runtime banks and event sample data listed in a map's manifest as soon as the map starts loading, so that
+ * the audio is resident before play begins. The previous map's references are released only once the next map's have
+ * been taken, so banks and event sample data shared between the two stay loaded.
+ *
+ * Events that play before their sample data has finished loading are recorded, and reported when the map is left or
+ * through the fmod.Warmup.Report console command.
+ */
+class FFMODMapWarmup
+{
+public:
+    FFMODMapWarmup(IFMODStudioModule &InModule, const FFMODAssetTable &InAssetTable);
+
+    /** Start warming up maps as they load, beginning with the map already in the game world if there is one */
+    void Start();
+
+    /** Stop warming up maps and release everything held for the current map */
+    void Stop();
+
+    /** Load sample data for events whose banks have finished loading, and track progress */
+    void Tick();
+
+    bool IsRunning() const { return bRunning; }
+
+    /** True once everything in the current map's manifest is resident, or if there is nothing to warm up */
+    bool IsWarmedUp() const { return Progress >= 1.0f; }
+
+    /** Fraction (0 to 1) of the events in the current map's manifest whose sample data has loaded */
+    float GetProgress() const { return Progress; }
+
+    /** Record an event instance being created, to report it if its sample data wasn't loaded yet */
+    void RecordPlay(FMOD::Studio::EventDescription *EventDesc);
+
+private:
+    struct FMapState
+    {
+        FMapState()
+            : StartTime(0.0)
+        {
+        }
+
+        FString MapName;
+        TArray<FGuid> Events;
+        TMap<FString, FMOD::Studio::Bank *> Banks;
+
+        /** Events waiting for their banks to load before their sample data can be loaded, and those with sample data loaded */
+        TSet<FGuid> PendingSampleData;
+        TSet<FGuid> LoadedSampleData;
+
+        /** Events still missing once the map's banks had finished loading, which are no longer retried */
+        TSet<FGuid> MissingEvents;
+
+        double StartTime;
+    };
+
+    struct FColdPlay
+    {
+        FColdPlay()
+            : Count(0)
+            , bInManifest(false)
+        {
+        }
+
+        FString Path;
+        int32 Count;
+        bool bInManifest;
+    };
+
+    void OnPreLoadMap(const FString &MapName);
+    void Begin(const FString &MapName);
+    void Release(FMapState &State);
+
+    bool IsBankLoading(const FMapState &State) const;
+    bool IsEventSettled(FMOD::Studio::System *System, const FGuid &Event, bool bBanksLoading) const;
+    void UpdateProgress();
+
+    void ReportColdPlays() const;
+
+    IFMODStudioModule &Module;
+    const FFMODAssetTable &AssetTable;
+    bool bRunning;
+
+    FMapState Current;
+    float Progress;
+
+    /** Events played cold in the current map, keyed by event GUID */
+    TMap<FGuid, FColdPlay> ColdPlays;
+
+    FDelegateHandle PreLoadMapHandle;
+    IConsoleObject *ReportCommand;
+};
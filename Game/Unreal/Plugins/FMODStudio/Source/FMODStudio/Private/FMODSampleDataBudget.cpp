@@ -0,0 +1,428 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#include "FMODSampleDataBudget.h"
+#include "FMODSettings.h"
+#include "FMODUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "fmod_studio.hpp"
+#include "FMODStudioPrivatePCH.h"
+
+#include <atomic>
+
+// Polling instance counts is cheap but not free, so playback is only sampled a few times a second
+static const double PlaybackCheckInterval = 0.5;
+
+static std::atomic<int64> gSampleDataBytes(0);
+
+static void DumpSampleData()
+{
+    if (!IFMODStudioModule::IsAvailable())
+    {
+        return;
+    }
+
+    TArray<FFMODSampleDataUsage> Usage;
+    IFMODStudioModule::Get().GetSampleDataWorkingSet(Usage);
+
+    int32 Budget = GetDefault<UFMODSettings>()->GetSampleDataBudget();
+    UE_LOG(LogFMOD, Log, TEXT("FMOD sample data: %.1f KB allocated, budget %s, %d events and banks resident"),
+        FFMODSampleDataBudget::GetAllocatedBytes() / 1024.0, Budget > 0 ? *FString::Printf(TEXT("%.1f KB"), Budget / 1024.0) : TEXT("unlimited"),
+        Usage.Num());
+
+    for (const FFMODSampleDataUsage &Entry : Usage)
+    {
+        UE_LOG(LogFMOD, Log, TEXT("  %s %s: %.1f KB, %d refs, %s"), Entry.bIsBank ? TEXT("Bank") : TEXT("Event"), *Entry.Name, Entry.Bytes / 1024.0,
+            Entry.References, Entry.bPlaying ? TEXT("playing") : *FString::Printf(TEXT("last used %.1fs ago"), Entry.SecondsSinceUsed));
+    }
+}
+
+static FAutoConsoleCommand DumpSampleDataCommand(TEXT("fmod.SampleData.Dump"),
+    TEXT("Log the events and banks with sample data resident, least recently used first"), FConsoleCommandDelegate::CreateStatic(&DumpSampleData));
+
+bool FFMODSampleDataBudget::FUnit::IsValid() const
+{
+    return EventDesc ? EventDesc->isValid() : (Bank && Bank->isValid());
+}
+
+bool FFMODSampleDataBudget::FUnit::IsLoading() const
+{
+    FMOD_STUDIO_LOADING_STATE State = FMOD_STUDIO_LOADING_STATE_ERROR;
+    if (EventDesc)
+    {
+        EventDesc->getSampleLoadingState(&State);
+    }
+    else
+    {
+        Bank->getSampleLoadingState(&State);
+    }
+    return State == FMOD_STUDIO_LOADING_STATE_LOADING;
+}
+
+bool FFMODSampleDataBudget::FUnit::UpdatePlaying()
+{
+    int Count = 0;
+
+    if (EventDesc)
+    {
+        EventDesc->getInstanceCount(&Count);
+        bPlaying = (Count > 0);
+        return bPlaying;
+    }
+
+    // The event list isn't available until a non-blocking bank load has finished
+    if (BankEvents.Num() == 0 && Bank->getEventCount(&Count) == FMOD_OK && Count > 0)
+    {
+        BankEvents.AddZeroed(Count);
+        Bank->getEventList(BankEvents.GetData(), Count, &Count);
+        BankEvents.SetNum(Count);
+    }
+
+    bPlaying = false;
+    for (FMOD::Studio::EventDescription *Event : BankEvents)
+    {
+        if (Event->getInstanceCount(&Count) == FMOD_OK && Count > 0)
+        {
+            bPlaying = true;
+            break;
+        }
+    }
+    return bPlaying;
+}
+
+FFMODSampleDataBudget::FFMODSampleDataBudget()
+    : MeasureStartBytes(0)
+    , LastPlaybackCheck(0.0)
+    , bWarnedOverBudget(false)
+{
+}
+
+void FFMODSampleDataBudget::LoadEvent(const FGuid &Guid, FMOD::Studio::EventDescription *EventDesc)
+{
+    FString Key = Guid.ToString(EGuidFormats::DigitsWithHyphensInBraces);
+    FUnit &Unit = Units.FindOrAdd(Key);
+
+    if (!Unit.EventDesc)
+    {
+        Unit.EventDesc = EventDesc;
+        Unit.Name = FMODUtils::GetPath(EventDesc);
+        if (Unit.Name.IsEmpty())
+        {
+            Unit.Name = Key;
+        }
+    }
+
+    if (++Unit.Refs == 1 || !Unit.bLoaded)
+    {
+        Load(Key, Unit);
+    }
+}
+
+void FFMODSampleDataBudget::UnloadEvent(const FGuid &Guid)
+{
+    Unload(Guid.ToString(EGuidFormats::DigitsWithHyphensInBraces));
+}
+
+void FFMODSampleDataBudget::LoadBank(const FString &Path, FMOD::Studio::Bank *Bank)
+{
+    FUnit &Unit = Units.FindOrAdd(Path);
+
+    if (!Unit.Bank)
+    {
+        Unit.Bank = Bank;
+        Unit.Name = Path;
+    }
+
+    if (++Unit.Refs == 1 || !Unit.bLoaded)
+    {
+        Load(Path, Unit);
+    }
+}
+
+void FFMODSampleDataBudget::UnloadBank(const FString &Path)
+{
+    Unload(Path);
+}
+
+int32 FFMODSampleDataBudget::SuspendBank(const FString &Path)
+{
+    FUnit Unit;
+    if (!Units.RemoveAndCopyValue(Path, Unit))
+    {
+        return 0;
+    }
+
+    Measuring.Remove(Path);
+    return Unit.Refs;
+}
+
+void FFMODSampleDataBudget::SuspendEvents(FMOD::Studio::Bank *Bank, TMap<FGuid, int32> &Refs)
+{
+    int Count = 0;
+    if (Bank->getEventCount(&Count) != FMOD_OK || Count == 0)
+    {
+        return;
+    }
+
+    TArray<FMOD::Studio::EventDescription *> Events;
+    Events.AddZeroed(Count);
+    Bank->getEventList(Events.GetData(), Count, &Count);
+    Events.SetNum(Count);
+
+    for (FMOD::Studio::EventDescription *EventDesc : Events)
+    {
+        FMOD::Studio::ID Id;
+        if (EventDesc->getID(&Id) != FMOD_OK)
+        {
+            continue;
+        }
+
+        FGuid Guid = FMODUtils::ConvertGuid(Id);
+        FString Key = Guid.ToString(EGuidFormats::DigitsWithHyphensInBraces);
+
+        FUnit Unit;
+        if (Units.RemoveAndCopyValue(Key, Unit))
+        {
+            Measuring.Remove(Key);
+            Refs.FindOrAdd(Guid) += Unit.Refs;
+        }
+    }
+}
+
+void FFMODSampleDataBudget::ResumeEvents(FMOD::Studio::Bank *Bank, const TMap<FGuid, int32> &Refs)
+{
+    int Count = 0;
+    if (Refs.Num() == 0 || Bank->getEventCount(&Count) != FMOD_OK || Count == 0)
+    {
+        return;
+    }
+
+    TArray<FMOD::Studio::EventDescription *> Events;
+    Events.AddZeroed(Count);
+    Bank->getEventList(Events.GetData(), Count, &Count);
+    Events.SetNum(Count);
+
+    for (FMOD::Studio::EventDescription *EventDesc : Events)
+    {
+        FMOD::Studio::ID Id;
+        if (EventDesc->getID(&Id) != FMOD_OK)
+        {
+            continue;
+        }
+
+        FGuid Guid = FMODUtils::ConvertGuid(Id);
+        if (const int32 *EventRefs = Refs.Find(Guid))
+        {
+            for (int32 i = 0; i < *EventRefs; ++i)
+            {
+                LoadEvent(Guid, EventDesc);
+            }
+        }
+    }
+}
+
+void FFMODSampleDataBudget::Load(const FString &Key, FUnit &Unit)
+{
+    if (Measuring.Num() == 0)
+    {
+        MeasureStartBytes = gSampleDataBytes;
+    }
+    Measuring.AddUnique(Key);
+
+    if (Unit.EventDesc)
+    {
+        verifyfmod(Unit.EventDesc->loadSampleData());
+    }
+    else
+    {
+        verifyfmod(Unit.Bank->loadSampleData());
+    }
+
+    Unit.bLoaded = true;
+    Unit.LastUsed = FPlatformTime::Seconds();
+}
+
+void FFMODSampleDataBudget::Unload(const FString &Key)
+{
+    FUnit *Unit = Units.Find(Key);
+    if (!Unit || --Unit->Refs > 0)
+    {
+        return;
+    }
+
+    if (Unit->bLoaded && Unit->IsValid())
+    {
+        Evict(*Unit);
+    }
+    Units.Remove(Key);
+}
+
+void FFMODSampleDataBudget::Evict(FUnit &Unit)
+{
+    if (Unit.EventDesc)
+    {
+        verifyfmod(Unit.EventDesc->unloadSampleData());
+    }
+    else
+    {
+        verifyfmod(Unit.Bank->unloadSampleData());
+    }
+    Unit.bLoaded = false;
+}
+
+void FFMODSampleDataBudget::Tick()
+{
+    if (Units.Num() == 0)
+    {
+        return;
+    }
+
+    // Handles go stale when the bank holding an event, or the bank itself, is unloaded elsewhere
+    for (auto It = Units.CreateIterator(); It; ++It)
+    {
+        if (!It.Value().IsValid())
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    UpdateMeasurement();
+
+    double Now = FPlatformTime::Seconds();
+    if (Now - LastPlaybackCheck < PlaybackCheckInterval)
+    {
+        return;
+    }
+    LastPlaybackCheck = Now;
+
+    for (TPair<FString, FUnit> &Pair : Units)
+    {
+        FUnit &Unit = Pair.Value;
+        if (Unit.UpdatePlaying())
+        {
+            Unit.LastUsed = Now;
+
+            // Playing loads the sample data regardless, so an evicted unit is made resident again rather than being
+            // loaded and released with each instance
+            if (!Unit.bLoaded)
+            {
+                Load(Pair.Key, Unit);
+            }
+        }
+    }
+
+    EnforceBudget();
+}
+
+void FFMODSampleDataBudget::UpdateMeasurement()
+{
+    if (Measuring.Num() == 0)
+    {
+        return;
+    }
+
+    int32 Completed = 0;
+    for (const FString &Key : Measuring)
+    {
+        const FUnit *Unit = Units.Find(Key);
+        if (Unit && Unit->IsLoading())
+        {
+            return;
+        }
+        Completed += Unit ? 1 : 0;
+    }
+
+    // Loads that overlapped share the growth evenly
+    int64 Growth = FMath::Max<int64>(0, gSampleDataBytes - MeasureStartBytes);
+    for (const FString &Key : Measuring)
+    {
+        if (FUnit *Unit = Units.Find(Key))
+        {
+            Unit->Bytes = Growth / FMath::Max(Completed, 1);
+        }
+    }
+    Measuring.Reset();
+}
+
+void FFMODSampleDataBudget::EnforceBudget()
+{
+    int64 Budget = GetDefault<UFMODSettings>()->GetSampleDataBudget();
+    int64 Excess = gSampleDataBytes - Budget;
+    if (Budget <= 0 || Excess <= 0)
+    {
+        bWarnedOverBudget = false;
+        return;
+    }
+
+    // Units measured at zero bytes found their data already resident, so evicting them wouldn't free anything
+    TArray<TPair<double, FString>> Candidates;
+    for (const TPair<FString, FUnit> &Pair : Units)
+    {
+        if (Pair.Value.bLoaded && !Pair.Value.bPlaying && Pair.Value.Bytes > 0 && !Measuring.Contains(Pair.Key))
+        {
+            Candidates.Add(TPair<double, FString>(Pair.Value.LastUsed, Pair.Key));
+        }
+    }
+    Candidates.Sort([](const TPair<double, FString> &A, const TPair<double, FString> &B) { return A.Key < B.Key; });
+
+    // Sample data is freed by the next system update, so stop once the estimated sizes cover the excess
+    int64 Freed = 0;
+    for (const TPair<double, FString> &Candidate : Candidates)
+    {
+        if (Freed >= Excess)
+        {
+            break;
+        }
+
+        FUnit &Unit = Units[Candidate.Value];
+        UE_LOG(LogFMOD, Verbose, TEXT("Evicting sample data for %s (%.1f KB) to stay within budget"), *Unit.Name, Unit.Bytes / 1024.0);
+        Evict(Unit);
+        Freed += Unit.Bytes;
+    }
+
+    if (Candidates.Num() == 0 && !bWarnedOverBudget)
+    {
+        UE_LOG(LogFMOD, Warning, TEXT("FMOD sample data is %.1f KB over budget and nothing resident can be evicted"), Excess / 1024.0);
+        bWarnedOverBudget = true;
+    }
+}
+
+void FFMODSampleDataBudget::Reset()
+{
+    Units.Reset();
+    Measuring.Reset();
+    bWarnedOverBudget = false;
+}
+
+void FFMODSampleDataBudget::GetWorkingSet(TArray<FFMODSampleDataUsage> &Usage) const
+{
+    double Now = FPlatformTime::Seconds();
+
+    for (const TPair<FString, FUnit> &Pair : Units)
+    {
+        const FUnit &Unit = Pair.Value;
+        if (!Unit.bLoaded)
+        {
+            continue;
+        }
+
+        FFMODSampleDataUsage &Entry = Usage.AddDefaulted_GetRef();
+        Entry.Name = Unit.Name;
+        Entry.Bytes = Unit.Bytes;
+        Entry.SecondsSinceUsed = (float)(Now - Unit.LastUsed);
+        Entry.References = Unit.Refs;
+        Entry.bIsBank = (Unit.Bank != nullptr);
+        Entry.bPlaying = Unit.bPlaying;
+    }
+
+    Usage.Sort([](const FFMODSampleDataUsage &A, const FFMODSampleDataUsage &B) { return A.SecondsSinceUsed > B.SecondsSinceUsed; });
+}
+
+void FFMODSampleDataBudget::TrackAllocation(int64 Delta)
+{
+    gSampleDataBytes += Delta;
+}
+
+int64 FFMODSampleDataBudget::GetAllocatedBytes()
+{
+    return gSampleDataBytes;
+}
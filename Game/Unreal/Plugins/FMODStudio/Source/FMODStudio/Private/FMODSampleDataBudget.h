@@ -0,0 +1,97 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2023.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FMODStudioModule.h"
+
+/**
+ * Tracks the sample data loaded for runtime events and banks, and keeps it within the sample data budget for the
+ * current platform by unloading whatever was played least recently. Loads are reference counted per event and bank.
+ *
+ * The total comes from the sizes of FMOD allocations tagged as sample data. Per event and bank sizes are
+ * measured from the change in that total while their sample data loads, so they are estimates when loads overlap or
+ * share samples.
+ *
+ * Evicted events and banks keep their references. Their sample data is loaded again by the next LoadEvent or LoadBank,
+ * or as soon as one of their events is seen playing.
+ */
+class FFMODSampleDataBudget
+{
+public:
+    FFMODSampleDataBudget();
+
+    void LoadEvent(const FGuid &Guid, FMOD::Studio::EventDescription *EventDesc);
+    void UnloadEvent(const FGuid &Guid);
+
+    void LoadBank(const FString &Path, FMOD::Studio::Bank *Bank);
+    void UnloadBank(const FString &Path);
+
+    /**
+     * Forget a bank, or the events in a bank, without unloading their sample data, ahead of the bank being unloaded
+     * and replaced. Returns the references held, to be restored with LoadBank and ResumeEvents once the replacement
+     * bank has loaded.
+     */
+    int32 SuspendBank(const FString &Path);
+    void SuspendEvents(FMOD::Studio::Bank *Bank, TMap<FGuid, int32> &Refs);
+    void ResumeEvents(FMOD::Studio::Bank *Bank, const TMap<FGuid, int32> &Refs);
+
+    /** Measure completed loads, track playback and evict over budget */
+    void Tick();
+
+    /** Forget everything without unloading, called before the runtime system is destroyed */
+    void Reset();
+
+    void GetWorkingSet(TArray<FFMODSampleDataUsage> &Usage) const;
+
+    /** Called from the FMOD memory callbacks for allocations tagged FMOD_MEMORY_SAMPLEDATA */
+    static void TrackAllocation(int64 Delta);
+    static int64 GetAllocatedBytes();
+
+private:
+    struct FUnit
+    {
+        FUnit()
+            : EventDesc(nullptr)
+            , Bank(nullptr)
+            , Refs(0)
+            , Bytes(0)
+            , LastUsed(0.0)
+            , bLoaded(false)
+            , bPlaying(false)
+        {
+        }
+
+        bool IsValid() const;
+        bool IsLoading() const;
+        bool UpdatePlaying();
+
+        FString Name;
+        FMOD::Studio::EventDescription *EventDesc;
+        FMOD::Studio::Bank *Bank;
+
+        /** Events in a bank unit, used to tell when the bank is in use */
+        TArray<FMOD::Studio::EventDescription *> BankEvents;
+
+        int32 Refs;
+        int64 Bytes;
+        double LastUsed;
+        bool bLoaded;
+        bool bPlaying;
+    };
+
+    void Load(const FString &Key, FUnit &Unit);
+    void Unload(const FString &Key);
+    void Evict(FUnit &Unit);
+    void UpdateMeasurement();
+    void EnforceBudget();
+
+    TMap<FString, FUnit> Units;
+
+    /** Units whose sample data is still loading, and the allocated total when the first of them started */
+    TArray<FString> Measuring;
+    int64 MeasureStartBytes;
+
+    double LastPlaybackCheck;
+    bool bWarnedOverBudget;
+};
@@ -39,10 +39,17 @@ UFMODSettings::UFMODSettings(const FObjectInitializer &ObjectInitializer)
     : Super(ObjectInitializer)
     , bLoadAllBanks(true)
     , bLoadAllSampleData(false)
+    , bMemoryMapBanks(false)
+    , bAsyncBankLoading(false)
+    , bLoadBanksPerLevel(false)
+    , bLoadLevelEventSampleData(true)
+    , BankUnloadLingerTime(5.0f)
+    , bWarmUpMapAudio(false)
     , bEnableLiveUpdate(true)
     , bEnableEditorLiveUpdate(false)
     , OutputFormat(EFMODSpeakerMode::Surround_5_1)
     , OutputType(EFMODOutput::TYPE_AUTODETECT)
+    , LocaleSwapDrainTime(10.0f)
     , Vol0VirtualLevel(0.001f)
     , SampleRate(0)
     , bMatchHardwareSampleRate(true)
@@ -51,13 +58,21 @@ UFMODSettings::UFMODSettings(const FObjectInitializer &ObjectInitializer)
     , DSPBufferLength(0)
     , DSPBufferCount(0)
     , FileBufferSize(2048)
+    , FileThreadCount(2)
+    , bEnableAsyncFileReads(false)
+    , FileCacheBlockSize(32768)
+    , FileCacheBlockCount(4)
+    , FileStreamDeadlineMs(20)
     , StudioUpdatePeriod(0)
     , bLockAllBuses(false)
     , LiveUpdatePort(9264)
     , EditorLiveUpdatePort(9265)
     , ReloadBanksDelay(5)
+    , bIncrementalBankReload(false)
     , bEnableAPIErrorLogging(false)
     , bEnableMemoryTracking(false)
+    , bRecordFileAccessTraces(false)
+    , bPrefetchFromFileAccessTraces(false)
     , ContentBrowserPrefix(TEXT("/Game/FMOD/"))
     , MasterBankName(TEXT("Master"))
     , LoggingLevel(LEVEL_WARNING)
@@ -243,6 +258,11 @@ int32 UFMODSettings::GetMemoryPoolSize() const
     return (Platforms.Contains(CurrentPlatform()) ? Platforms.Find(CurrentPlatform())->CustomPoolSize : 0);
 }
 
+int32 UFMODSettings::GetSampleDataBudget() const
+{
+    return (Platforms.Contains(CurrentPlatform()) ? Platforms.Find(CurrentPlatform())->SampleDataBudget : 0);
+}
+
 int32 UFMODSettings::GetRealChannelCount() const
 {
     return Platforms.Contains(CurrentPlatform()) ? Platforms.Find(CurrentPlatform())->RealChannelCount : RealChannelCount;
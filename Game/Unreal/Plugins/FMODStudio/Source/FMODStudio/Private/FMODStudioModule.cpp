@@ -5,10 +5,20 @@
 #include "FMODAudioComponent.h"
 #include "FMODBlueprintStatics.h"
 #include "FMODAssetTable.h"
+#include "FMODAssetResolver.h"
+#include "FMODBankResidency.h"
 #include "FMODFileCallbacks.h"
+#include "FMODFileStats.h"
+#include "FMODIOTrace.h"
+#include "FMODLevelBankManager.h"
+#include "FMODLocaleSwap.h"
 #include "FMODUtils.h"
 #include "FMODEvent.h"
+#include "FMODBus.h"
+#include "FMODVCA.h"
 #include "FMODListener.h"
+#include "FMODMapWarmup.h"
+#include "FMODSampleDataBudget.h"
 #include "FMODSnapshotReverb.h"
 
 #include "FMODAudioLinkModule.h"
@@ -17,6 +27,8 @@
 #endif
 
 #include "Async/Async.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/App.h"
 #include "Misc/CommandLine.h"
@@ -55,6 +67,7 @@ DECLARE_FLOAT_COUNTER_STAT(TEXT("FMOD CPU - Mixer"), STAT_FMOD_CPUMixer, STATGRO
 DECLARE_FLOAT_COUNTER_STAT(TEXT("FMOD CPU - Studio"), STAT_FMOD_CPUStudio, STATGROUP_FMOD);
 DECLARE_MEMORY_STAT(TEXT("FMOD Memory - Current"), STAT_FMOD_Current_Memory, STATGROUP_FMOD);
 DECLARE_MEMORY_STAT(TEXT("FMOD Memory - Max"), STAT_FMOD_Max_Memory, STATGROUP_FMOD);
+DECLARE_MEMORY_STAT(TEXT("FMOD Memory - Sample Data"), STAT_FMOD_SampleData_Memory, STATGROUP_FMOD);
 DECLARE_DWORD_COUNTER_STAT(TEXT("FMOD Channels - Total"), STAT_FMOD_Total_Channels, STATGROUP_FMOD);
 DECLARE_DWORD_COUNTER_STAT(TEXT("FMOD Channels - Real"), STAT_FMOD_Real_Channels, STATGROUP_FMOD);
 
@@ -62,16 +75,104 @@ const TCHAR *FMODSystemContextNames[EFMODSystemContext::Max] = {
     TEXT("Auditioning"), TEXT("Runtime"), TEXT("Editor"),
 };
 
+// Set before the callbacks are installed when the allocator can't report block sizes. Every FMOD allocation then
+// carries a header with its requested size and type, so sample data is counted without a lookup
+static bool gFMODAllocSizeHeader = false;
+
+struct FFMODAllocHeader
+{
+    uint32 Size;
+    uint32 bSampleData;
+};
+
+// Keeps the pointer returned to FMOD on the allocator's 16 byte alignment
+static const SIZE_T FMODAllocHeaderSize = 16;
+static const uint32 FMODAllocAlignment = 16;
+
 void *F_CALLBACK FMODMemoryAlloc(unsigned int size, FMOD_MEMORY_TYPE type, const char *sourcestr)
 {
-    return FMemory::Malloc(size);
+    if (gFMODAllocSizeHeader)
+    {
+        uint8 *base = (uint8 *)FMemory::Malloc(size + FMODAllocHeaderSize, FMODAllocAlignment);
+        if (!base)
+        {
+            return nullptr;
+        }
+
+        FFMODAllocHeader *header = (FFMODAllocHeader *)base;
+        header->Size = size;
+        header->bSampleData = (type & FMOD_MEMORY_SAMPLEDATA) ? 1 : 0;
+        if (header->bSampleData)
+        {
+            FFMODSampleDataBudget::TrackAllocation(size);
+        }
+        return base + FMODAllocHeaderSize;
+    }
+
+    void *ptr = FMemory::Malloc(size);
+    if (ptr && (type & FMOD_MEMORY_SAMPLEDATA))
+    {
+        FFMODSampleDataBudget::TrackAllocation(FMemory::GetAllocSize(ptr));
+    }
+    return ptr;
 }
 void *F_CALLBACK FMODMemoryRealloc(void *ptr, unsigned int size, FMOD_MEMORY_TYPE type, const char *sourcestr)
 {
+    if (gFMODAllocSizeHeader)
+    {
+        if (!ptr)
+        {
+            return FMODMemoryAlloc(size, type, sourcestr);
+        }
+
+        uint8 *base = (uint8 *)ptr - FMODAllocHeaderSize;
+        uint32 oldSize = ((FFMODAllocHeader *)base)->Size;
+
+        uint8 *newBase = (uint8 *)FMemory::Realloc(base, size + FMODAllocHeaderSize, FMODAllocAlignment);
+        if (!newBase)
+        {
+            return nullptr;
+        }
+
+        FFMODAllocHeader *header = (FFMODAllocHeader *)newBase;
+        header->Size = size;
+        if (header->bSampleData)
+        {
+            FFMODSampleDataBudget::TrackAllocation((int64)size - oldSize);
+        }
+        return newBase + FMODAllocHeaderSize;
+    }
+
+    if (type & FMOD_MEMORY_SAMPLEDATA)
+    {
+        int64 oldSize = ptr ? FMemory::GetAllocSize(ptr) : 0;
+        void *newPtr = FMemory::Realloc(ptr, size);
+        FFMODSampleDataBudget::TrackAllocation((newPtr ? (int64)FMemory::GetAllocSize(newPtr) : 0) - oldSize);
+        return newPtr;
+    }
     return FMemory::Realloc(ptr, size);
 }
 void F_CALLBACK FMODMemoryFree(void *ptr, FMOD_MEMORY_TYPE type, const char *sourcestr)
 {
+    if (gFMODAllocSizeHeader)
+    {
+        if (ptr)
+        {
+            uint8 *base = (uint8 *)ptr - FMODAllocHeaderSize;
+            FFMODAllocHeader *header = (FFMODAllocHeader *)base;
+            if (header->bSampleData)
+            {
+                FFMODSampleDataBudget::TrackAllocation(-(int64)header->Size);
+            }
+            FMemory::Free(base);
+        }
+        return;
+    }
+
+    if (ptr && (type & FMOD_MEMORY_SAMPLEDATA))
+    {
+        FFMODSampleDataBudget::TrackAllocation(-(int64)FMemory::GetAllocSize(ptr));
+    }
     FMemory::Free(ptr);
 }
 
@@ -152,6 +253,66 @@ public:
     FUpdateListenerPosition UpdateListenerPosition;
 };
 
+struct NamedBankEntry
+{
+    NamedBankEntry()
+        : Bank(nullptr)
+    {
+    }
+    NamedBankEntry(const FString &InName, FMOD::Studio::Bank *InBank, FMOD_RESULT InResult)
+        : Name(InName)
+        , Bank(InBank)
+        , Result(InResult)
+    {
+    }
+
+    FString Name;
+    FMOD::Studio::Bank *Bank;
+    FMOD_RESULT Result;
+};
+
+/** A bank loaded from a memory mapped file, which must stay mapped until FMOD has finished unloading the bank */
+struct FFMODMappedBank
+{
+    FFMODMappedBank(FMOD::Studio::Bank *BankIn, IMappedFileHandle *HandleIn, IMappedFileRegion *RegionIn)
+        : Bank(BankIn)
+        , Handle(HandleIn)
+        , Region(RegionIn)
+        , bUnloadRequested(false)
+    {
+    }
+
+    void Release()
+    {
+        delete Region;
+        Region = nullptr;
+        delete Handle;
+        Handle = nullptr;
+    }
+
+    FMOD::Studio::Bank *Bank;
+    IMappedFileHandle *Handle;
+    IMappedFileRegion *Region;
+    bool bUnloadRequested;
+};
+
+/** Studio handles already looked up by GUID in one system, which become invalid when a bank is unloaded from it */
+struct FFMODHandleCache
+{
+    void Reset()
+    {
+        EventDescriptions.Reset();
+        Buses.Reset();
+        VCAs.Reset();
+        GlobalParameterIDs.Reset();
+    }
+
+    TMap<FGuid, FMOD::Studio::EventDescription *> EventDescriptions;
+    TMap<FGuid, FMOD::Studio::Bus *> Buses;
+    TMap<FGuid, FMOD::Studio::VCA *> VCAs;
+    TMap<FName, FMOD_STUDIO_PARAMETER_ID> GlobalParameterIDs;
+};
+
 class FFMODStudioModule : public IFMODStudioModule
 {
     TUniquePtr<FFMODAudioLinkModule> FMODAudioLinkModule;
@@ -169,6 +330,15 @@ public:
         , bListenerMoved(true)
         , bAllowLiveUpdate(true)
         , bBanksLoaded(false)
+        , AssetResolver(AssetTable)
+        , PendingBankCount(0)
+        , bPendingLoadSampleData(false)
+        , bLoadBanksOnAssetTableLoad(false)
+        , bWarnedNoEventBanks(false)
+        , BankResidency(*this, SampleDataBudget)
+        , LocaleSwap(*this, BankResidency, SampleDataBudget)
+        , LevelBankManager(*this)
+        , MapWarmup(*this, AssetTable)
         , LowLevelLibHandle(nullptr)
         , StudioLibHandle(nullptr)
         , bMixerPaused(false)
@@ -204,9 +374,15 @@ public:
 
     void LoadBanks(EFMODSystemContext::Type Type);
     void UnloadBanks(EFMODSystemContext::Type Type);
+    FMOD::Studio::EventDescription *FindEventDescription(EFMODSystemContext::Type Context, const FGuid &EventGuid);
+    void ReleaseMappedBanks(EFMODSystemContext::Type Type, bool bForce);
+    void FinishBankLoad(EFMODSystemContext::Type Type, NamedBankEntry &Entry, bool bLoadSampleData);
+    void UpdatePendingBankLoads();
 
 #if WITH_EDITOR
     void ReloadBanks();
+    void ReloadChangedBanks(const TArray<FString> &ChangedFiles);
+    void ReloadBankFile(EFMODSystemContext::Type Type, const FString &Path);
     void LoadEditorBanks();
     void UnloadEditorBanks();
 #endif
@@ -221,6 +397,10 @@ public:
 
     virtual FMOD::Studio::System *GetStudioSystem(EFMODSystemContext::Type Context) override;
     virtual FMOD::Studio::EventDescription *GetEventDescription(const UFMODEvent *Event, EFMODSystemContext::Type Type) override;
+    virtual FMOD::Studio::Bus *GetBus(const UFMODBus *Bus, EFMODSystemContext::Type Context) override;
+    virtual FMOD::Studio::VCA *GetVCA(const UFMODVCA *Vca, EFMODSystemContext::Type Context) override;
+    virtual bool GetParameterID(FMOD::Studio::EventDescription *EventDesc, FName Name, FMOD_STUDIO_PARAMETER_ID &ID) override;
+    virtual bool GetGlobalParameterID(FName Name, FMOD_STUDIO_PARAMETER_ID &ID, EFMODSystemContext::Type Context) override;
     virtual FMOD::Studio::EventInstance *CreateAuditioningInstance(const UFMODEvent *Event) override;
     virtual void StopAuditioningInstance() override;
 
@@ -237,6 +417,8 @@ public:
 
     virtual UFMODAsset *FindAssetByName(const FString &Name) override;
     virtual UFMODEvent *FindEventByName(const FString &Name) override;
+
+    virtual void FindAssetByNameAsync(const FString &Name, FFMODAssetFound Callback) override;
     virtual FString GetBankPath(const UFMODBank &Bank) override;
     virtual void GetAllBankPaths(TArray<FString> &Paths, bool IncludeMasterBank) const override;
 
@@ -260,8 +442,69 @@ public:
 
     virtual bool AreBanksLoaded() override;
 
+    virtual float GetBankLoadProgress() override;
+
+    virtual FFMODBankLoadProgress &OnBankLoadProgress() override { return BankLoadProgressDelegate; }
+
+    virtual FSimpleMulticastDelegate &OnBanksLoaded() override { return BanksLoadedDelegate; }
+
+    virtual FMOD_RESULT LoadBankFile(EFMODSystemContext::Type Context, const FString &Path, FMOD_STUDIO_LOAD_BANK_FLAGS Flags, FMOD::Studio::Bank **Bank) override;
+
+    virtual void UnloadBank(EFMODSystemContext::Type Context, FMOD::Studio::Bank *Bank) override;
+
+    virtual FMOD::Studio::Bank *AcquireBank(const FString &Path, bool bBlocking, EFMODBankOwner::Type Owner) override
+    {
+        return BankResidency.AcquireBank(Path, bBlocking, Owner);
+    }
+
+    virtual bool ReleaseBank(const FString &Path, EFMODBankOwner::Type Owner) override { return BankResidency.ReleaseBank(Path, Owner); }
+
+    virtual bool IsBankAcquired(const FString &Path) override { return BankResidency.IsAcquired(Path); }
+
+    virtual FMOD::Studio::Bank *AcquireBankSampleData(const FString &Path, bool bBlocking, EFMODBankOwner::Type Owner) override
+    {
+        return BankResidency.AcquireSampleData(Path, bBlocking, Owner);
+    }
+
+    virtual bool ReleaseBankSampleData(const FString &Path, EFMODBankOwner::Type Owner) override
+    {
+        return BankResidency.ReleaseSampleData(Path, Owner);
+    }
+
+    virtual bool GetEventBankPaths(const FGuid &EventGuid, TArray<FString> &Paths) override { return AssetTable.GetEventBankPaths(EventGuid, Paths); }
+
+    virtual void LoadBanksForEvents(const TArray<FGuid> &EventGuids, bool bBlocking) override;
+
+    virtual void UnloadBanksForEvents(const TArray<FGuid> &EventGuids) override;
+
+    bool GetBankPathsForEvents(const TArray<FGuid> &EventGuids, TArray<FString> &Paths);
+
+    virtual bool LoadEventSampleData(const FGuid &EventGuid) override;
+
+    virtual void UnloadEventSampleData(const FGuid &EventGuid) override { SampleDataBudget.UnloadEvent(EventGuid); }
+
+    virtual int64 GetSampleDataMemory() override { return FFMODSampleDataBudget::GetAllocatedBytes(); }
+
+    virtual void GetSampleDataWorkingSet(TArray<FFMODSampleDataUsage> &Usage) override { SampleDataBudget.GetWorkingSet(Usage); }
+
+    virtual bool IsMapAudioWarmedUp() override { return MapWarmup.IsWarmedUp(); }
+
+    virtual float GetMapAudioWarmupProgress() override { return MapWarmup.GetProgress(); }
+
+    virtual void NotifyEventPlayed(FMOD::Studio::EventDescription *EventDesc) override { MapWarmup.RecordPlay(EventDesc); }
+
+    virtual void NotifyLevelEventUsed(ULevel *Level, const FGuid &EventGuid, bool bBlocking) override
+    {
+        if (LevelBankManager.IsRunning())
+        {
+            LevelBankManager.AddLevelEvent(Level, EventGuid, bBlocking);
+        }
+    }
+
     virtual bool SetLocale(const FString& Locale) override;
 
+    virtual bool IsLocaleSwapInProgress() override { return LocaleSwap.IsInProgress(); }
+
     virtual FString GetLocale() override;
 
     virtual FString GetDefaultLocale() override;
@@ -277,6 +520,12 @@ public:
     FMOD::Studio::System *StudioSystem[EFMODSystemContext::Max];
     FMOD::Studio::EventInstance *AuditioningInstance;
 
+    /** Handles already looked up in each system, cleared when a bank is unloaded from it */
+    FFMODHandleCache HandleCaches[EFMODSystemContext::Max];
+
+    /** Parameter IDs by name for each event description, cleared with the handle caches */
+    TMap<FMOD::Studio::EventDescription *, TMap<FName, FMOD_STUDIO_PARAMETER_ID>> EventParameterIDs;
+
     /** The delegate to be invoked when this profiler manager ticks. */
     FTickerDelegate OnTick;
 
@@ -289,9 +538,47 @@ public:
     /** Table of assets with name and guid */
     FFMODAssetTable AssetTable;
 
+    /** Assets resolved from Studio paths, loaded in the background on request */
+    FFMODAssetResolver AssetResolver;
+
     /** List of failed bank files */
     TArray<FString> FailedBankLoads[EFMODSystemContext::Max];
 
+    /** Runtime banks still loading asynchronously, polled each tick */
+    TArray<NamedBankEntry> PendingBankLoads;
+    int32 PendingBankCount;
+    bool bPendingLoadSampleData;
+
+    /** Set when runtime banks are waiting for the asset table to finish loading */
+    bool bLoadBanksOnAssetTableLoad;
+
+    /** Load runtime banks still waiting for the asset table, blocking until the table has loaded */
+    void LoadDeferredBanks(EFMODSystemContext::Type Context);
+
+    /** Set once the missing event dependencies in the bank lookup have been reported */
+    bool bWarnedNoEventBanks;
+
+    FFMODBankLoadProgress BankLoadProgressDelegate;
+    FSimpleMulticastDelegate BanksLoadedDelegate;
+
+    /** Sample data loaded for runtime events and banks, kept within the platform budget */
+    FFMODSampleDataBudget SampleDataBudget;
+
+    /** Reference counted runtime banks, loaded on demand */
+    FFMODBankResidency BankResidency;
+
+    /** Swaps loaded localized banks when the locale changes */
+    FFMODLocaleSwap LocaleSwap;
+
+    /** Loads banks for the events used by the levels in game worlds */
+    FFMODLevelBankManager LevelBankManager;
+
+    /** Loads the banks and sample data in each map's manifest while the map loads */
+    FFMODMapWarmup MapWarmup;
+
+    /** Banks loaded from memory mapped files */
+    TArray<FFMODMappedBank> MappedBanks[EFMODSystemContext::Max];
+
     /** List of required plugins we found when loading banks. */
     TArray<FString> RequiredPlugins;
 
@@ -496,9 +783,24 @@ void FFMODStudioModule::StartupModule()
         {
             MemPool = FMemory::Malloc(size);
             verifyfmod(FMOD::Memory_Initialize(MemPool, size, nullptr, nullptr, nullptr));
+
+            if (Settings.GetSampleDataBudget() > 0)
+            {
+                UE_LOG(LogFMOD, Warning, TEXT("The sample data budget is ignored while a custom memory pool is in use"));
+            }
         }
         else
         {
+            // Decided once, before FMOD allocates anything, since every block must be freed the way it was allocated
+            void *probe = FMemory::Malloc(1);
+            gFMODAllocSizeHeader = (FMemory::GetAllocSize(probe) == 0);
+            FMemory::Free(probe);
+
+            if (gFMODAllocSizeHeader && Settings.GetSampleDataBudget() > 0)
+            {
+                UE_LOG(LogFMOD, Log, TEXT("The allocator can't report block sizes, so FMOD allocations carry a size header for the sample data budget"));
+            }
+
             verifyfmod(FMOD::Memory_Initialize(0, 0, FMODMemoryAlloc, FMODMemoryRealloc, FMODMemoryFree));
         }
 
@@ -507,10 +809,12 @@ void FFMODStudioModule::StartupModule()
 #endif
 
         AcquireFMODFileSystem();
+        FFMODIOTrace::Startup();
 
         if (GIsEditor)
         {
-            AssetTable.Load();
+            // Loaded in the background, anything that needs the table before it is ready waits for it
+            AssetTable.LoadAsync();
             AssetTable.SetLocale(GetDefaultLocale());
             CreateStudioSystem(EFMODSystemContext::Auditioning);
             CreateStudioSystem(EFMODSystemContext::Editor);
@@ -795,6 +1099,18 @@ void FFMODStudioModule::DestroyStudioSystem(EFMODSystemContext::Type Type)
         ClockSinks[Type].Reset();
     }
 
+    if (Type == EFMODSystemContext::Runtime)
+    {
+        PendingBankLoads.Reset();
+        PendingBankCount = 0;
+        bLoadBanksOnAssetTableLoad = false;
+        LevelBankManager.Stop();
+        MapWarmup.Stop();
+        LocaleSwap.Reset();
+        BankResidency.Reset();
+        SampleDataBudget.Reset();
+    }
+
     UnloadBanks(Type);
 
     if (StudioSystem[Type])
@@ -802,6 +1118,11 @@ void FFMODStudioModule::DestroyStudioSystem(EFMODSystemContext::Type Type)
         verifyfmod(StudioSystem[Type]->release());
         StudioSystem[Type] = nullptr;
     }
+    HandleCaches[Type].Reset();
+    EventParameterIDs.Reset();
+
+    // Releasing the system has unloaded every bank, so all mappings can go
+    ReleaseMappedBanks(Type, true);
 }
 
 void FFMODStudioModule::UnloadBanks(EFMODSystemContext::Type Type)
@@ -819,12 +1140,27 @@ void FFMODStudioModule::UnloadBanks(EFMODSystemContext::Type Type)
 
             for (int i = 0; i < bankCount; i++)
             {
-                verifyfmod(bankArray[i]->unload());
+                UnloadBank(Type, bankArray[i]);
             }
         }
     }
 }
 
+void FFMODStudioModule::ReleaseMappedBanks(EFMODSystemContext::Type Type, bool bForce)
+{
+    for (int32 i = MappedBanks[Type].Num() - 1; i >= 0; --i)
+    {
+        FFMODMappedBank &Entry = MappedBanks[Type][i];
+
+        // FMOD reads from the mapped memory until the bank handle becomes invalid
+        if (bForce || (Entry.bUnloadRequested && !Entry.Bank->isValid()))
+        {
+            Entry.Release();
+            MappedBanks[Type].RemoveAtSwap(i, 1, false);
+        }
+    }
+}
+
 bool FFMODStudioModule::Tick(float DeltaTime)
 {
     if (ClockSinks[EFMODSystemContext::Auditioning].IsValid())
@@ -843,6 +1179,7 @@ bool FFMODStudioModule::Tick(float DeltaTime)
         FMOD::Memory_GetStats(&currentAlloc, &maxAlloc, false);
         SET_MEMORY_STAT(STAT_FMOD_Current_Memory, currentAlloc);
         SET_MEMORY_STAT(STAT_FMOD_Max_Memory, maxAlloc);
+        SET_MEMORY_STAT(STAT_FMOD_SampleData_Memory, FFMODSampleDataBudget::GetAllocatedBytes());
 
         int channels, realChannels;
         FMOD::System *lowlevel;
@@ -857,6 +1194,44 @@ bool FFMODStudioModule::Tick(float DeltaTime)
     {
         verifyfmod(ClockSinks[EFMODSystemContext::Editor]->LastResult);
     }
+
+    if (bLoadBanksOnAssetTableLoad && !AssetTable.IsLoading())
+    {
+        LoadDeferredBanks(EFMODSystemContext::Runtime);
+    }
+
+    AssetResolver.Tick();
+
+    if (PendingBankLoads.Num() > 0)
+    {
+        UpdatePendingBankLoads();
+    }
+
+    if (LevelBankManager.IsRunning())
+    {
+        LevelBankManager.Tick();
+    }
+
+    if (MapWarmup.IsRunning())
+    {
+        MapWarmup.Tick();
+    }
+
+    // Swaps wait for the startup banks, whose paths were resolved for the old locale
+    if (LocaleSwap.IsInProgress() && PendingBankLoads.Num() == 0)
+    {
+        LocaleSwap.Tick();
+    }
+
+    BankResidency.Tick();
+    SampleDataBudget.Tick();
+
+    if (MappedBanks[EFMODSystemContext::Runtime].Num() > 0)
+    {
+        ReleaseMappedBanks(EFMODSystemContext::Runtime, false);
+    }
+
+    FFMODFileStats::Tick();
     return true;
 }
 
@@ -1142,14 +1517,31 @@ void FFMODStudioModule::SetInPIE(bool bInPIE, bool simulating)
         // TODO: Stop sounds for the Editor system? What should happen if the user previews a sequence with transport
         // controls then starts a PIE session? What does happen?
 
-        AssetTable.Load();
+        const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+
+        // The editor keeps the table loaded and reloads it when banks change, so only the first entry loads it
+        if (!AssetTable.IsLoaded() && !AssetTable.IsLoading())
+        {
+            AssetTable.LoadAsync();
+            AssetResolver.ClearCache();
+        }
         AssetTable.SetLocale(GetDefaultLocale());
 
         ListenerCount = 1;
         CreateStudioSystem(EFMODSystemContext::Runtime);
-        LoadBanks(EFMODSystemContext::Runtime);
 
-        const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+        // The banks wait for the table in Tick rather than blocking here, unless something needs them sooner
+        if (AssetTable.IsLoading())
+        {
+            UE_LOG(LogFMOD, Verbose, TEXT("Loading runtime banks once the asset table has loaded"));
+            bBanksLoaded = false;
+            bLoadBanksOnAssetTableLoad = true;
+        }
+        else
+        {
+            LoadBanks(EFMODSystemContext::Runtime);
+        }
+
         flags = Settings.LoggingLevel;
     }
     else
@@ -1165,7 +1557,12 @@ void FFMODStudioModule::SetInPIE(bool bInPIE, bool simulating)
 
 UFMODAsset *FFMODStudioModule::FindAssetByName(const FString &Name)
 {
-    return AssetTable.GetAssetByStudioPath(Name);
+    return AssetResolver.Find(Name);
+}
+
+void FFMODStudioModule::FindAssetByNameAsync(const FString &Name, FFMODAssetFound Callback)
+{
+    AssetResolver.FindAsync(Name, MoveTemp(Callback));
 }
 
 UFMODEvent *FFMODStudioModule::FindEventByName(const FString &Name)
@@ -1242,6 +1639,7 @@ void FFMODStudioModule::ShutdownModule()
 
     if (StudioLibHandle && LowLevelLibHandle)
     {
+        FFMODIOTrace::Shutdown();
         ReleaseFMODFileSystem();
     }
 
@@ -1268,27 +1666,144 @@ void FFMODStudioModule::ShutdownModule()
     UE_LOG(LogFMOD, Verbose, TEXT("FFMODStudioModule finished unloading"));
 }
 
-struct NamedBankEntry
+bool FFMODStudioModule::AreBanksLoaded()
 {
-    NamedBankEntry()
-        : Bank(nullptr)
+    return bBanksLoaded;
+}
+
+float FFMODStudioModule::GetBankLoadProgress()
+{
+    if (bBanksLoaded)
     {
+        return 1.0f;
     }
-    NamedBankEntry(const FString &InName, FMOD::Studio::Bank *InBank, FMOD_RESULT InResult)
-        : Name(InName)
-        , Bank(InBank)
-        , Result(InResult)
+    else if (PendingBankCount > 0)
     {
+        return (float)(PendingBankCount - PendingBankLoads.Num()) / PendingBankCount;
     }
+    return 0.0f;
+}
 
-    FString Name;
-    FMOD::Studio::Bank *Bank;
-    FMOD_RESULT Result;
-};
+FMOD_RESULT FFMODStudioModule::LoadBankFile(EFMODSystemContext::Type Context, const FString &Path, FMOD_STUDIO_LOAD_BANK_FLAGS Flags, FMOD::Studio::Bank **Bank)
+{
+    if (!StudioSystem[Context])
+    {
+        return FMOD_ERR_UNINITIALIZED;
+    }
 
-bool FFMODStudioModule::AreBanksLoaded()
+    const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+
+    if (Context == EFMODSystemContext::Runtime && Settings.bMemoryMapBanks)
+    {
+        // OpenMapped fails for files inside pak files, in which case fall back to loading from file
+        IMappedFileHandle *Handle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path);
+        IMappedFileRegion *Region = Handle ? Handle->MapRegion() : nullptr;
+
+        // Regions start on a page boundary which satisfies FMOD_STUDIO_LOAD_MEMORY_ALIGNMENT
+        if (Region && Region->GetMappedSize() > 0 && IsAligned(Region->GetMappedPtr(), FMOD_STUDIO_LOAD_MEMORY_ALIGNMENT))
+        {
+            FMOD_RESULT Result = StudioSystem[Context]->loadBankMemory((const char *)Region->GetMappedPtr(), (int)Region->GetMappedSize(),
+                FMOD_STUDIO_LOAD_MEMORY_POINT, Flags, Bank);
+
+            if (Result == FMOD_OK)
+            {
+                UE_LOG(LogFMOD, Verbose, TEXT("Memory mapped bank: %s"), *Path);
+                MappedBanks[Context].Add(FFMODMappedBank(*Bank, Handle, Region));
+                return Result;
+            }
+
+            // Nothing references the memory if the load failed
+            delete Region;
+            delete Handle;
+            return Result;
+        }
+
+        UE_LOG(LogFMOD, Verbose, TEXT("Could not memory map bank, loading from file: %s"), *Path);
+        delete Region;
+        delete Handle;
+    }
+
+    return StudioSystem[Context]->loadBankFile(TCHAR_TO_UTF8(*Path), Flags, Bank);
+}
+
+bool FFMODStudioModule::GetBankPathsForEvents(const TArray<FGuid> &EventGuids, TArray<FString> &Paths)
 {
-    return bBanksLoaded;
+    for (const FGuid &EventGuid : EventGuids)
+    {
+        if (!AssetTable.GetEventBankPaths(EventGuid, Paths))
+        {
+            if (!bWarnedNoEventBanks)
+            {
+                UE_LOG(LogFMOD, Warning, TEXT("The bank lookup has no event dependencies, rebuild the FMOD banks to generate them"));
+                bWarnedNoEventBanks = true;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+void FFMODStudioModule::LoadBanksForEvents(const TArray<FGuid> &EventGuids, bool bBlocking)
+{
+    TArray<FString> Paths;
+    if (GetBankPathsForEvents(EventGuids, Paths))
+    {
+        for (const FString &Path : Paths)
+        {
+            BankResidency.AcquireBank(Path, bBlocking, EFMODBankOwner::Code);
+        }
+    }
+}
+
+void FFMODStudioModule::UnloadBanksForEvents(const TArray<FGuid> &EventGuids)
+{
+    TArray<FString> Paths;
+    if (GetBankPathsForEvents(EventGuids, Paths))
+    {
+        for (const FString &Path : Paths)
+        {
+            BankResidency.ReleaseBank(Path, EFMODBankOwner::Code);
+        }
+    }
+}
+
+bool FFMODStudioModule::LoadEventSampleData(const FGuid &EventGuid)
+{
+    if (!StudioSystem[EFMODSystemContext::Runtime])
+    {
+        return false;
+    }
+
+    FMOD::Studio::EventDescription *EventDesc = FindEventDescription(EFMODSystemContext::Runtime, EventGuid);
+    if (!EventDesc)
+    {
+        return false;
+    }
+
+    SampleDataBudget.LoadEvent(EventGuid, EventDesc);
+    return true;
+}
+
+void FFMODStudioModule::UnloadBank(EFMODSystemContext::Type Context, FMOD::Studio::Bank *Bank)
+{
+    if (!Bank)
+    {
+        return;
+    }
+
+    // Handles for anything in the bank become invalid, and the rest are cheap to look up again
+    HandleCaches[Context].Reset();
+    EventParameterIDs.Reset();
+
+    for (FFMODMappedBank &Entry : MappedBanks[Context])
+    {
+        if (Entry.Bank == Bank)
+        {
+            Entry.bUnloadRequested = true;
+        }
+    }
+
+    verifyfmod(Bank->unload());
 }
 
 bool FFMODStudioModule::SetLocale(const FString& LocaleName)
@@ -1299,7 +1814,22 @@ bool FFMODStudioModule::SetLocale(const FString& LocaleName)
     {
         if (Locale.LocaleName == LocaleName)
         {
+            // Nothing can have been loaded for the old locale yet
+            if (AssetTable.IsLoading())
+            {
+                AssetTable.SetLocale(Locale.LocaleCode);
+                return true;
+            }
+
+            TMap<FGuid, FString> OldPaths, NewPaths;
+            AssetTable.GetBankPathsByGuid(OldPaths);
             AssetTable.SetLocale(Locale.LocaleCode);
+            AssetTable.GetBankPathsByGuid(NewPaths);
+
+            if (StudioSystem[EFMODSystemContext::Runtime])
+            {
+                LocaleSwap.Begin(OldPaths, NewPaths);
+            }
             return true;
         }
     }
@@ -1343,6 +1873,11 @@ void FFMODStudioModule::LoadBanks(EFMODSystemContext::Type Type)
     {
         RequiredPlugins.Reset();
     }
+    else
+    {
+        PendingBankLoads.Reset();
+        PendingBankCount = 0;
+    }
 
     if (StudioSystem[Type] != nullptr && Settings.IsBankPathSet())
     {
@@ -1351,7 +1886,8 @@ void FFMODStudioModule::LoadBanks(EFMODSystemContext::Type Type)
         /*
             Queue up all banks to load asynchronously then wait at the end.
         */
-        bool bLoadAllBanks = ((Type == EFMODSystemContext::Auditioning) || (Type == EFMODSystemContext::Editor) || Settings.bLoadAllBanks);
+        bool bLoadBanksPerLevel = ((Type == EFMODSystemContext::Runtime) && Settings.bLoadBanksPerLevel);
+        bool bLoadAllBanks = ((Type == EFMODSystemContext::Auditioning) || (Type == EFMODSystemContext::Editor) || (Settings.bLoadAllBanks && !bLoadBanksPerLevel));
         bool bLoadSampleData = ((Type == EFMODSystemContext::Runtime) && Settings.bLoadAllSampleData);
         bool bLockAllBuses = ((Type == EFMODSystemContext::Runtime) && Settings.bLockAllBuses);
         FMOD_STUDIO_LOAD_BANK_FLAGS BankFlags = (bLockAllBuses ? FMOD_STUDIO_LOAD_BANK_NORMAL : FMOD_STUDIO_LOAD_BANK_NONBLOCKING);
@@ -1371,7 +1907,7 @@ void FFMODStudioModule::LoadBanks(EFMODSystemContext::Type Type)
         {
             FString MasterBankPath = Settings.GetFullBankPath() / AssetTable.GetMasterBankPath();
             UE_LOG(LogFMOD, Verbose, TEXT("Loading master bank: %s"), *MasterBankPath);
-            Result = StudioSystem[Type]->loadBankFile(TCHAR_TO_UTF8(*MasterBankPath), BankFlags, &MasterBank);
+            Result = LoadBankFile(Type, MasterBankPath, BankFlags, &MasterBank);
             BankEntries.Add(NamedBankEntry(MasterBankPath, MasterBank, Result));
         }
 
@@ -1381,7 +1917,7 @@ void FFMODStudioModule::LoadBanks(EFMODSystemContext::Type Type)
             FString MasterAssetsBankPath = Settings.GetFullBankPath() / AssetTable.GetMasterAssetsBankPath();
             if (FPaths::FileExists(MasterAssetsBankPath))
             {
-                Result = StudioSystem[Type]->loadBankFile(TCHAR_TO_UTF8(*MasterAssetsBankPath), BankFlags, &MasterAssetsBank);
+                Result = LoadBankFile(Type, MasterAssetsBankPath, BankFlags, &MasterAssetsBank);
                 BankEntries.Add(NamedBankEntry(MasterAssetsBankPath, MasterAssetsBank, Result));
             }
         }
@@ -1395,7 +1931,7 @@ void FFMODStudioModule::LoadBanks(EFMODSystemContext::Type Type)
                 FString StringsBankPath = Settings.GetFullBankPath() / AssetTable.GetMasterStringsBankPath();
                 UE_LOG(LogFMOD, Verbose, TEXT("Loading strings bank: %s"), *StringsBankPath);
                 FMOD::Studio::Bank *StringsBank = nullptr;
-                Result = StudioSystem[Type]->loadBankFile(TCHAR_TO_UTF8(*StringsBankPath), BankFlags, &StringsBank);
+                Result = LoadBankFile(Type, StringsBankPath, BankFlags, &StringsBank);
                 BankEntries.Add(NamedBankEntry(StringsBankPath, StringsBank, Result));
             }
 
@@ -1415,7 +1951,7 @@ void FFMODStudioModule::LoadBanks(EFMODSystemContext::Type Type)
                     UE_LOG(LogFMOD, Log, TEXT("Loading bank: %s"), *OtherFile);
 
                     FMOD::Studio::Bank *OtherBank;
-                    Result = StudioSystem[Type]->loadBankFile(TCHAR_TO_UTF8(*OtherFile), BankFlags, &OtherBank);
+                    Result = LoadBankFile(Type, OtherFile, BankFlags, &OtherBank);
                     BankEntries.Add(NamedBankEntry(OtherFile, OtherBank, Result));
                 }
             }
@@ -1440,43 +1976,120 @@ void FFMODStudioModule::LoadBanks(EFMODSystemContext::Type Type)
             }
         }
 
+        if ((Type == EFMODSystemContext::Runtime) && Settings.bAsyncBankLoading && !bLockAllBuses && BankEntries.Num() > 0)
+        {
+            // Tick polls the loading states and finishes each bank as it completes
+            UE_LOG(LogFMOD, Verbose, TEXT("Loading %d banks asynchronously"), BankEntries.Num());
+            PendingBankLoads = MoveTemp(BankEntries);
+            PendingBankCount = PendingBankLoads.Num();
+            bPendingLoadSampleData = bLoadSampleData;
+            bBanksLoaded = false;
+            return;
+        }
+
         // Wait for all banks to load.
         StudioSystem[Type]->flushCommands();
 
         for (NamedBankEntry &Entry : BankEntries)
         {
-            if (Entry.Result == FMOD_OK)
+            FinishBankLoad(Type, Entry, bLoadSampleData);
+        }
+    }
+
+    bBanksLoaded = true;
+
+    if (Type == EFMODSystemContext::Runtime)
+    {
+        if (Settings.bLoadBanksPerLevel && StudioSystem[Type] != nullptr)
+        {
+            LevelBankManager.Start();
+        }
+        if (Settings.bWarmUpMapAudio && StudioSystem[Type] != nullptr)
+        {
+            MapWarmup.Start();
+        }
+        BanksLoadedDelegate.Broadcast();
+    }
+}
+
+void FFMODStudioModule::FinishBankLoad(EFMODSystemContext::Type Type, NamedBankEntry &Entry, bool bLoadSampleData)
+{
+    if (Entry.Result == FMOD_OK)
+    {
+        FMOD_STUDIO_LOADING_STATE BankLoadingState = FMOD_STUDIO_LOADING_STATE_ERROR;
+        Entry.Result = Entry.Bank->getLoadingState(&BankLoadingState);
+        if (BankLoadingState == FMOD_STUDIO_LOADING_STATE_ERROR)
+        {
+            UnloadBank(Type, Entry.Bank);
+            Entry.Bank = nullptr;
+        }
+        else if (bLoadSampleData && Type == EFMODSystemContext::Runtime)
+        {
+            SampleDataBudget.LoadBank(Entry.Name, Entry.Bank);
+        }
+        else if (bLoadSampleData)
+        {
+            verifyfmod(Entry.Bank->loadSampleData());
+        }
+    }
+    if (Entry.Bank == nullptr || Entry.Result != FMOD_OK)
+    {
+        FString ErrorMessage;
+        if (!FPaths::FileExists(Entry.Name))
+        {
+            ErrorMessage = "File does not exist";
+        }
+        else
+        {
+            ErrorMessage = UTF8_TO_TCHAR(FMOD_ErrorString(Entry.Result));
+        }
+        UE_LOG(LogFMOD, Warning, TEXT("Failed to load bank: %s (%s)"), *Entry.Name, *ErrorMessage);
+        FailedBankLoads[Type].Add(FString::Printf(TEXT("%s (%s)"), *FPaths::GetBaseFilename(Entry.Name), *ErrorMessage));
+    }
+}
+
+void FFMODStudioModule::UpdatePendingBankLoads()
+{
+    int32 Finished = 0;
+
+    for (int32 i = PendingBankLoads.Num() - 1; i >= 0; --i)
+    {
+        NamedBankEntry &Entry = PendingBankLoads[i];
+
+        if (Entry.Result == FMOD_OK && Entry.Bank)
+        {
+            FMOD_STUDIO_LOADING_STATE BankLoadingState = FMOD_STUDIO_LOADING_STATE_ERROR;
+            if (Entry.Bank->getLoadingState(&BankLoadingState) == FMOD_OK && BankLoadingState == FMOD_STUDIO_LOADING_STATE_LOADING)
             {
-                FMOD_STUDIO_LOADING_STATE BankLoadingState = FMOD_STUDIO_LOADING_STATE_ERROR;
-                Entry.Result = Entry.Bank->getLoadingState(&BankLoadingState);
-                if (BankLoadingState == FMOD_STUDIO_LOADING_STATE_ERROR)
-                {
-                    Entry.Bank->unload();
-                    Entry.Bank = nullptr;
-                }
-                else if (bLoadSampleData)
-                {
-                    verifyfmod(Entry.Bank->loadSampleData());
-                }
+                continue;
             }
-            if (Entry.Bank == nullptr || Entry.Result != FMOD_OK)
+        }
+
+        FinishBankLoad(EFMODSystemContext::Runtime, Entry, bPendingLoadSampleData);
+        PendingBankLoads.RemoveAt(i);
+        ++Finished;
+    }
+
+    if (Finished > 0)
+    {
+        BankLoadProgressDelegate.Broadcast(PendingBankCount - PendingBankLoads.Num(), PendingBankCount);
+
+        if (PendingBankLoads.Num() == 0)
+        {
+            UE_LOG(LogFMOD, Verbose, TEXT("Finished loading %d banks asynchronously"), PendingBankCount);
+            bBanksLoaded = true;
+
+            if (GetDefault<UFMODSettings>()->bLoadBanksPerLevel)
             {
-                FString ErrorMessage;
-                if (!FPaths::FileExists(Entry.Name))
-                {
-                    ErrorMessage = "File does not exist";
-                }
-                else
-                {
-                    ErrorMessage = UTF8_TO_TCHAR(FMOD_ErrorString(Entry.Result));
-                }
-                UE_LOG(LogFMOD, Warning, TEXT("Failed to load bank: %s (%s)"), *Entry.Name, *ErrorMessage);
-                FailedBankLoads[Type].Add(FString::Printf(TEXT("%s (%s)"), *FPaths::GetBaseFilename(Entry.Name), *ErrorMessage));
+                LevelBankManager.Start();
             }
+            if (GetDefault<UFMODSettings>()->bWarmUpMapAudio)
+            {
+                MapWarmup.Start();
+            }
+            BanksLoadedDelegate.Broadcast();
         }
     }
-
-    bBanksLoaded = true;
 }
 
 #if WITH_EDITOR
@@ -1489,11 +2102,121 @@ void FFMODStudioModule::ReloadBanks()
     DestroyStudioSystem(EFMODSystemContext::Editor);
 
     AssetTable.Load();
+    AssetResolver.ClearCache();
 
     LoadBanks(EFMODSystemContext::Auditioning);
     CreateStudioSystem(EFMODSystemContext::Editor);
 }
 
+void FFMODStudioModule::ReloadChangedBanks(const TArray<FString> &ChangedFiles)
+{
+    const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+
+    AssetTable.Load();
+    AssetResolver.ClearCache();
+
+    const FString MasterBankFiles[] = {
+        FPaths::ConvertRelativePathToFull(Settings.GetFullBankPath() / AssetTable.GetMasterBankPath()),
+        FPaths::ConvertRelativePathToFull(Settings.GetFullBankPath() / AssetTable.GetMasterAssetsBankPath()),
+        FPaths::ConvertRelativePathToFull(Settings.GetFullBankPath() / AssetTable.GetMasterStringsBankPath()),
+    };
+
+    // Only the banks for the active locale are loaded, so changes to other locales' banks are skipped, as are banks
+    // LoadBanks skips by name
+    TArray<FString> BankPaths;
+    AssetTable.GetAllBankPaths(BankPaths, false);
+    TSet<FString> LoadedFiles;
+    for (const FString &BankPath : BankPaths)
+    {
+        if (Settings.SkipLoadBankName.Len() && BankPath.Contains(Settings.SkipLoadBankName))
+        {
+            continue;
+        }
+        LoadedFiles.Add(FPaths::ConvertRelativePathToFull(BankPath));
+    }
+
+    TArray<FString> FilesToReload;
+    for (const FString &File : ChangedFiles)
+    {
+        FString FullPath = FPaths::ConvertRelativePathToFull(File);
+
+        // Every bank depends on the master banks, and a removed bank can no longer be matched to its loaded handle
+        if (!FPaths::FileExists(FullPath) || FullPath == MasterBankFiles[0] || FullPath == MasterBankFiles[1] || FullPath == MasterBankFiles[2])
+        {
+            UE_LOG(LogFMOD, Verbose, TEXT("%s changed, reloading all banks"), *FPaths::GetCleanFilename(File));
+            ReloadBanks();
+            return;
+        }
+
+        if (LoadedFiles.Contains(FullPath))
+        {
+            FilesToReload.Add(FullPath);
+        }
+    }
+
+    UE_LOG(LogFMOD, Verbose, TEXT("Reloading %d changed banks"), FilesToReload.Num());
+
+    StopAuditioningInstance();
+
+    const EFMODSystemContext::Type Contexts[] = { EFMODSystemContext::Auditioning, EFMODSystemContext::Editor };
+    for (EFMODSystemContext::Type Type : Contexts)
+    {
+        // The editor system only has banks while Sequencer has loaded them
+        int BankCount = 0;
+        if (!StudioSystem[Type] || StudioSystem[Type]->getBankCount(&BankCount) != FMOD_OK || BankCount == 0)
+        {
+            continue;
+        }
+
+        for (const FString &File : FilesToReload)
+        {
+            ReloadBankFile(Type, File);
+        }
+    }
+}
+
+void FFMODStudioModule::ReloadBankFile(EFMODSystemContext::Type Type, const FString &Path)
+{
+    // Loading a bank that is already loaded fails but returns the existing handle, which is how the old version is found
+    FMOD::Studio::Bank *Bank = nullptr;
+    FMOD_RESULT Result = LoadBankFile(Type, Path, FMOD_STUDIO_LOAD_BANK_NORMAL, &Bank);
+    bool bReloadSampleData = false;
+
+    if (Result == FMOD_ERR_EVENT_ALREADY_LOADED && Bank)
+    {
+        // Sample data loaded on the old version is loaded again on the new one
+        FMOD_STUDIO_LOADING_STATE SampleState = FMOD_STUDIO_LOADING_STATE_UNLOADED;
+        if (Bank->getSampleLoadingState(&SampleState) == FMOD_OK)
+        {
+            bReloadSampleData = (SampleState == FMOD_STUDIO_LOADING_STATE_LOADING || SampleState == FMOD_STUDIO_LOADING_STATE_LOADED);
+        }
+
+        UnloadBank(Type, Bank);
+        StudioSystem[Type]->flushCommands();
+
+        Bank = nullptr;
+        Result = LoadBankFile(Type, Path, FMOD_STUDIO_LOAD_BANK_NORMAL, &Bank);
+    }
+
+    FString BankName = FPaths::GetBaseFilename(Path);
+    FailedBankLoads[Type].RemoveAll([&BankName](const FString &Entry) { return Entry.StartsWith(BankName + TEXT(" (")); });
+
+    if (Result != FMOD_OK)
+    {
+        FString ErrorMessage = UTF8_TO_TCHAR(FMOD_ErrorString(Result));
+        UE_LOG(LogFMOD, Warning, TEXT("Failed to reload bank: %s (%s)"), *Path, *ErrorMessage);
+        FailedBankLoads[Type].Add(FString::Printf(TEXT("%s (%s)"), *BankName, *ErrorMessage));
+        return;
+    }
+
+    if (bReloadSampleData && Bank)
+    {
+        verifyfmod(Bank->loadSampleData());
+    }
+
+    UE_LOG(LogFMOD, Log, TEXT("Reloaded bank %s for context %s"), *Path, FMODSystemContextNames[Type]);
+}
+
 void FFMODStudioModule::LoadEditorBanks()
 {
     LoadBanks(EFMODSystemContext::Editor);
@@ -1522,14 +2245,155 @@ FMOD::Studio::EventDescription *FFMODStudioModule::GetEventDescription(const UFM
     }
     if (StudioSystem[Context] != nullptr && IsValid(Event) && Event->AssetGuid.IsValid())
     {
-        FMOD::Studio::ID Guid = FMODUtils::ConvertGuid(Event->AssetGuid);
-        FMOD::Studio::EventDescription *EventDesc = nullptr;
-        StudioSystem[Context]->getEventByID(&Guid, &EventDesc);
-        return EventDesc;
+        return FindEventDescription(Context, Event->AssetGuid);
     }
     return nullptr;
 }
 
+void FFMODStudioModule::LoadDeferredBanks(EFMODSystemContext::Type Context)
+{
+    if (Context != EFMODSystemContext::Runtime || !bLoadBanksOnAssetTableLoad)
+    {
+        return;
+    }
+
+    bLoadBanksOnAssetTableLoad = false;
+    AssetTable.WaitForLoad();
+    LoadBanks(EFMODSystemContext::Runtime);
+}
+
+FMOD::Studio::EventDescription *FFMODStudioModule::FindEventDescription(EFMODSystemContext::Type Context, const FGuid &EventGuid)
+{
+    // Anything played before the deferred banks have loaded needs them now
+    LoadDeferredBanks(Context);
+
+    if (FMOD::Studio::EventDescription **Cached = HandleCaches[Context].EventDescriptions.Find(EventGuid))
+    {
+        return *Cached;
+    }
+
+    FMOD::Studio::ID Guid = FMODUtils::ConvertGuid(EventGuid);
+    FMOD::Studio::EventDescription *EventDesc = nullptr;
+    if (StudioSystem[Context]->getEventByID(&Guid, &EventDesc) != FMOD_OK || !EventDesc)
+    {
+        // Not cached, the event may be in a bank that hasn't loaded yet
+        return nullptr;
+    }
+
+    HandleCaches[Context].EventDescriptions.Add(EventGuid, EventDesc);
+    return EventDesc;
+}
+
+FMOD::Studio::Bus *FFMODStudioModule::GetBus(const UFMODBus *Bus, EFMODSystemContext::Type Context)
+{
+    if (Context == EFMODSystemContext::Max)
+    {
+        Context = (bIsInPIE ? EFMODSystemContext::Runtime : EFMODSystemContext::Auditioning);
+    }
+    LoadDeferredBanks(Context);
+    if (StudioSystem[Context] == nullptr || !IsValid(Bus) || !Bus->AssetGuid.IsValid())
+    {
+        return nullptr;
+    }
+
+    if (FMOD::Studio::Bus **Cached = HandleCaches[Context].Buses.Find(Bus->AssetGuid))
+    {
+        return *Cached;
+    }
+
+    FMOD::Studio::ID Guid = FMODUtils::ConvertGuid(Bus->AssetGuid);
+    FMOD::Studio::Bus *BusHandle = nullptr;
+    if (StudioSystem[Context]->getBusByID(&Guid, &BusHandle) != FMOD_OK || !BusHandle)
+    {
+        return nullptr;
+    }
+
+    HandleCaches[Context].Buses.Add(Bus->AssetGuid, BusHandle);
+    return BusHandle;
+}
+
+FMOD::Studio::VCA *FFMODStudioModule::GetVCA(const UFMODVCA *Vca, EFMODSystemContext::Type Context)
+{
+    if (Context == EFMODSystemContext::Max)
+    {
+        Context = (bIsInPIE ? EFMODSystemContext::Runtime : EFMODSystemContext::Auditioning);
+    }
+    LoadDeferredBanks(Context);
+    if (StudioSystem[Context] == nullptr || !IsValid(Vca) || !Vca->AssetGuid.IsValid())
+    {
+        return nullptr;
+    }
+
+    if (FMOD::Studio::VCA **Cached = HandleCaches[Context].VCAs.Find(Vca->AssetGuid))
+    {
+        return *Cached;
+    }
+
+    FMOD::Studio::ID Guid = FMODUtils::ConvertGuid(Vca->AssetGuid);
+    FMOD::Studio::VCA *VcaHandle = nullptr;
+    if (StudioSystem[Context]->getVCAByID(&Guid, &VcaHandle) != FMOD_OK || !VcaHandle)
+    {
+        return nullptr;
+    }
+
+    HandleCaches[Context].VCAs.Add(Vca->AssetGuid, VcaHandle);
+    return VcaHandle;
+}
+
+bool FFMODStudioModule::GetParameterID(FMOD::Studio::EventDescription *EventDesc, FName Name, FMOD_STUDIO_PARAMETER_ID &ID)
+{
+    if (EventDesc == nullptr)
+    {
+        return false;
+    }
+
+    TMap<FName, FMOD_STUDIO_PARAMETER_ID> &ParameterIDs = EventParameterIDs.FindOrAdd(EventDesc);
+    if (const FMOD_STUDIO_PARAMETER_ID *Cached = ParameterIDs.Find(Name))
+    {
+        ID = *Cached;
+        return true;
+    }
+
+    FMOD_STUDIO_PARAMETER_DESCRIPTION Description = {};
+    if (EventDesc->getParameterDescriptionByName(TCHAR_TO_UTF8(*Name.ToString()), &Description) != FMOD_OK)
+    {
+        return false;
+    }
+
+    ParameterIDs.Add(Name, Description.id);
+    ID = Description.id;
+    return true;
+}
+
+bool FFMODStudioModule::GetGlobalParameterID(FName Name, FMOD_STUDIO_PARAMETER_ID &ID, EFMODSystemContext::Type Context)
+{
+    if (Context == EFMODSystemContext::Max)
+    {
+        Context = (bIsInPIE ? EFMODSystemContext::Runtime : EFMODSystemContext::Auditioning);
+    }
+    LoadDeferredBanks(Context);
+    if (StudioSystem[Context] == nullptr)
+    {
+        return false;
+    }
+
+    if (const FMOD_STUDIO_PARAMETER_ID *Cached = HandleCaches[Context].GlobalParameterIDs.Find(Name))
+    {
+        ID = *Cached;
+        return true;
+    }
+
+    FMOD_STUDIO_PARAMETER_DESCRIPTION Description = {};
+    if (StudioSystem[Context]->getParameterDescriptionByName(TCHAR_TO_UTF8(*Name.ToString()), &Description) != FMOD_OK)
+    {
+        return false;
+    }
+
+    HandleCaches[Context].GlobalParameterIDs.Add(Name, Description.id);
+    ID = Description.id;
+    return true;
+}
+
 FMOD::Studio::EventInstance *FFMODStudioModule::CreateAuditioningInstance(const UFMODEvent *Event)
 {
     StopAuditioningInstance();
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Modules/ModuleManager.h"
+#include "fmod_studio_common.h"
 
 namespace FMOD
 {
@@ -11,17 +12,27 @@ namespace Studio
 class System;
 class EventDescription;
 class EventInstance;
+class Bank;
+class Bus;
+class VCA;
 }
 }
 
 class UFMODAsset;
 class UFMODBank;
+class UFMODBus;
 class UFMODEvent;
+class UFMODVCA;
+class ULevel;
 class UWorld;
 class AAudioVolume;
 struct FInteriorSettings;
 struct FFMODListener; // Currently only for private use, we don't export this type
 
+/** Broadcast as runtime banks finish loading, with the number of banks finished and the total being loaded */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FFMODBankLoadProgress, int32 /* BanksLoaded */, int32 /* BankCount */);
+DECLARE_DELEGATE_OneParam(FFMODAssetFound, UFMODAsset * /* Asset */);
+
 // Which FMOD Studio system to use
 namespace EFMODSystemContext
 {
@@ -41,6 +52,44 @@ enum Type
 };
 }
 
+// Who holds a reference on a runtime bank, so that each caller only ever releases its own references
+namespace EFMODBankOwner
+{
+enum Type
+{
+    // Native callers such as per-level bank loading, map warm-up and LoadBanksForEvents
+    Code,
+
+    // The LoadBank and UnloadBank Blueprint functions
+    BlueprintBank,
+
+    // The LoadBankSampleData and UnloadBankSampleData Blueprint functions
+    BlueprintSampleData,
+
+    // Max number of types
+    Max
+};
+}
+
+/** Resident sample data for one event or bank, as reported by GetSampleDataWorkingSet */
+struct FFMODSampleDataUsage
+{
+    /** Event path or bank file path */
+    FString Name;
+
+    /** Memory attributed to this event or bank when its sample data loaded */
+    int64 Bytes;
+
+    /** Seconds since the event, or an event in the bank, was last seen playing */
+    float SecondsSinceUsed;
+
+    /** Number of outstanding load requests */
+    int32 References;
+
+    bool bIsBank;
+    bool bPlaying;
+};
+
 /**
  * The public interface to this module
  */
@@ -87,6 +136,12 @@ public:
 	 */
     virtual UFMODEvent *FindEventByName(const FString &Name) = 0;
 
+    /**
+	 * Look up an asset given its name without blocking, loading it in the background if needed. Callback is called on
+	 * the game thread with the asset, or null if there is no such asset.
+	 */
+    virtual void FindAssetByNameAsync(const FString &Name, FFMODAssetFound Callback) = 0;
+
     /**
       * Get the disk path for a Bank asset
       */
@@ -100,10 +155,35 @@ public:
     /**
 	 * Get an event description.
 	 * The system type can control which Studio system to use, or leave it as System_Max for it to choose automatically.
+	 * Descriptions are cached per system until a bank is unloaded from it, so repeated calls don't go back to FMOD.
 	 */
     virtual FMOD::Studio::EventDescription *GetEventDescription(
         const UFMODEvent *Event, EFMODSystemContext::Type Context = EFMODSystemContext::Max) = 0;
 
+    /**
+	 * Get a bus handle, cached the same way as event descriptions.
+	 * The system type can control which Studio system to use, or leave it as System_Max for it to choose automatically.
+	 */
+    virtual FMOD::Studio::Bus *GetBus(const UFMODBus *Bus, EFMODSystemContext::Type Context = EFMODSystemContext::Max) = 0;
+
+    /**
+	 * Get a VCA handle, cached the same way as event descriptions.
+	 * The system type can control which Studio system to use, or leave it as System_Max for it to choose automatically.
+	 */
+    virtual FMOD::Studio::VCA *GetVCA(const UFMODVCA *Vca, EFMODSystemContext::Type Context = EFMODSystemContext::Max) = 0;
+
+    /**
+	 * Look up the ID of an event parameter by name, so it can be set with setParameterByID.
+	 * IDs are cached per event description until a bank is unloaded. Returns false if the event has no such parameter.
+	 */
+    virtual bool GetParameterID(FMOD::Studio::EventDescription *EventDesc, FName Name, FMOD_STUDIO_PARAMETER_ID &ID) = 0;
+
+    /**
+	 * Look up the ID of a global parameter by name, cached the same way as event parameter IDs.
+	 * The system type can control which Studio system to use, or leave it as System_Max for it to choose automatically.
+	 */
+    virtual bool GetGlobalParameterID(FName Name, FMOD_STUDIO_PARAMETER_ID &ID, EFMODSystemContext::Type Context = EFMODSystemContext::Max) = 0;
+
     /**
 	 * Create a single auditioning instance using the auditioning system
 	 */
@@ -155,9 +235,91 @@ public:
     /** Returns if the banks have been loaded */
     virtual bool AreBanksLoaded() = 0;
 
-    /** Set active locale. Locale must be the locale name of one of the configured project locales */
+    /** Returns the fraction of runtime banks that have finished loading, 1 once AreBanksLoaded is true */
+    virtual float GetBankLoadProgress() = 0;
+
+    /** Called as each runtime bank finishes loading when loading asynchronously */
+    virtual FFMODBankLoadProgress &OnBankLoadProgress() = 0;
+
+    /** Called once all runtime banks have finished loading, whether synchronously or asynchronously */
+    virtual FSimpleMulticastDelegate &OnBanksLoaded() = 0;
+
+    /** Load a bank file into a Studio system, memory mapping it for the runtime system if enabled in the settings */
+    virtual FMOD_RESULT LoadBankFile(EFMODSystemContext::Type Context, const FString &Path, FMOD_STUDIO_LOAD_BANK_FLAGS Flags, FMOD::Studio::Bank **Bank) = 0;
+
+    /** Unload a bank, releasing any memory mapping behind it once FMOD has finished with it */
+    virtual void UnloadBank(EFMODSystemContext::Type Context, FMOD::Studio::Bank *Bank) = 0;
+
+    /**
+     * Take a reference on a runtime bank, loading it if it isn't already resident, and return the bank.
+     * The bank stays loaded until every reference has been released and the linger time in the settings has passed.
+     */
+    virtual FMOD::Studio::Bank *AcquireBank(const FString &Path, bool bBlocking, EFMODBankOwner::Type Owner) = 0;
+
+    /** Release a reference taken with AcquireBank by the same owner. Returns false if the owner has no such reference */
+    virtual bool ReleaseBank(const FString &Path, EFMODBankOwner::Type Owner) = 0;
+
+    /** Return true if any owner holds a reference on a runtime bank or its sample data */
+    virtual bool IsBankAcquired(const FString &Path) = 0;
+
+    /**
+     * Add the full paths of the banks an event needs to Paths, including its sample data and stream banks.
+     * Returns false if the bank lookup predates event dependencies and the banks need rebuilding.
+     */
+    virtual bool GetEventBankPaths(const FGuid &EventGuid, TArray<FString> &Paths) = 0;
+
+    /** Take a reference on exactly the runtime banks needed by a set of events */
+    virtual void LoadBanksForEvents(const TArray<FGuid> &EventGuids, bool bBlocking) = 0;
+
+    /** Release the references taken by LoadBanksForEvents for the same set of events */
+    virtual void UnloadBanksForEvents(const TArray<FGuid> &EventGuids) = 0;
+
+    /** Take a reference on the sample data of a runtime bank. This also keeps the bank itself loaded */
+    virtual FMOD::Studio::Bank *AcquireBankSampleData(const FString &Path, bool bBlocking, EFMODBankOwner::Type Owner) = 0;
+
+    /** Release a reference taken with AcquireBankSampleData by the same owner. Returns false if the owner has no such reference */
+    virtual bool ReleaseBankSampleData(const FString &Path, EFMODBankOwner::Type Owner) = 0;
+
+    /**
+     * Load the sample data for a runtime event, counted against the sample data budget. If the data is evicted to stay
+     * within the budget, it is loaded again the next time the event plays or is requested.
+     * Returns false if the event isn't available yet because none of the banks containing it are loaded.
+     */
+    virtual bool LoadEventSampleData(const FGuid &EventGuid) = 0;
+
+    /** Release a request made with LoadEventSampleData */
+    virtual void UnloadEventSampleData(const FGuid &EventGuid) = 0;
+
+    /** Return the sample data memory currently allocated by the runtime system, in bytes */
+    virtual int64 GetSampleDataMemory() = 0;
+
+    /** Return the events and banks with sample data resident, least recently used first */
+    virtual void GetSampleDataWorkingSet(TArray<FFMODSampleDataUsage> &Usage) = 0;
+
+    /** Return true once the banks and sample data in the current map's manifest are resident, or if there is nothing to warm up */
+    virtual bool IsMapAudioWarmedUp() = 0;
+
+    /** Return the fraction (0 to 1) of the events in the current map's manifest whose sample data has loaded */
+    virtual float GetMapAudioWarmupProgress() = 0;
+
+    /** Called when a runtime event instance is created, to report events played before their sample data was loaded */
+    virtual void NotifyEventPlayed(FMOD::Studio::EventDescription *EventDesc) = 0;
+
+    /**
+     * Called when an audio component in a game world registers or plays. When banks are loaded per level, the event's
+     * banks are held with the component's level, waiting for them to finish loading if bBlocking is set.
+     */
+    virtual void NotifyLevelEventUsed(ULevel *Level, const FGuid &EventGuid, bool bBlocking) = 0;
+
+    /**
+     * Set active locale. Locale must be the locale name of one of the configured project locales. Loaded runtime banks
+     * for the old locale are swapped for the new locale's in the background.
+     */
     virtual bool SetLocale(const FString& Locale) = 0;
 
+    /** Return true while loaded banks are still being swapped after a locale change */
+    virtual bool IsLocaleSwapInProgress() = 0;
+
     /** Get active locale. */
     virtual FString GetLocale() = 0;
 
@@ -169,6 +331,12 @@ public:
     /** Called by the editor module when banks have been modified on disk */
     virtual void ReloadBanks() = 0;
 
+    /**
+     * Called by the editor module when some bank files have changed on disk. Only those banks are reloaded, and the
+     * editor system is kept running, unless a master bank changed or a bank was removed.
+     */
+    virtual void ReloadChangedBanks(const TArray<FString> &ChangedFiles) = 0;
+
     /** Load Editor banks for auditioning in Sequnecer. */
     virtual void LoadEditorBanks() = 0;
 
@@ -42,8 +42,10 @@ private:
     };
 
     void BuildBankLookup(const FString &AssetName, const FString &PackagePath, const UFMODSettings &InSettings, TArray<UObject*>& AssetsToSave);
+    void BuildEventBanks(TArray<UObject*>& AssetsToSave);
     void BuildAssets(const UFMODSettings &InSettings, const FString &AssetLookupName, const FString &AssetLookupPath, TArray<UObject*>& AssetsToSave,
         TArray<UObject*>& AssetsToDelete);
+    void BuildCompactLookup(const FString &PackagePath, TArray<UObject*>& AssetsToSave);
 
     FString GetAssetClassName(UClass *AssetClass);
     bool MakeAssetCreateInfo(const FGuid &AssetGuid, const FString &StudioPath, AssetCreateInfo *CreateInfo);
@@ -53,4 +55,7 @@ private:
 
     FMOD::Studio::System *StudioSystem{};
     UFMODBankLookup *BankLookup{};
+
+    /** GUID of each bank file found by BuildBankLookup */
+    TMap<FString, FGuid> BankFileGuids;
 };
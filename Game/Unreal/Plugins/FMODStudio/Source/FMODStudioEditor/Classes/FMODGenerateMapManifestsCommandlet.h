@@ -0,0 +1,23 @@
+// Copyright (c), Firelight Technologies Pty, Ltd.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FMODGenerateMapManifestsCommandlet.generated.h"
+
+/**
+ * Writes the FMOD events, and the banks they need, that each map can play to the map manifests used to warm up
+ * map audio at runtime. Run it before cooking, after the FMOD assets have been generated.
+ *
+ * Usage: -run=FMODGenerateMapManifests [-Maps=/Game/Maps/MapA+/Game/Maps/MapB]
+ */
+UCLASS()
+class UFMODGenerateMapManifestsCommandlet : public UCommandlet
+{
+    GENERATED_UCLASS_BODY()
+
+    //~ Begin UCommandlet Interface
+    virtual int32 Main(const FString &Params) override;
+    //~ End UCommandlet Interface
+};
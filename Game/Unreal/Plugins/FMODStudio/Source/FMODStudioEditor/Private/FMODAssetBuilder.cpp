@@ -6,6 +6,7 @@
 #include "FMODBank.h"
 #include "FMODBankLookup.h"
 #include "FMODBus.h"
+#include "FMODCompactLookup.h"
 #include "FMODEvent.h"
 #include "FMODSettings.h"
 #include "FMODSnapshot.h"
@@ -48,7 +49,9 @@ void FFMODAssetBuilder::ProcessBanks()
     const UFMODSettings& Settings = *GetDefault<UFMODSettings>();
     FString PackagePath = Settings.GetFullContentPath() / FFMODAssetTable::PrivateDataPath();
     BuildBankLookup(FFMODAssetTable::BankLookupName(), PackagePath, Settings, AssetsToSave);
+    BuildEventBanks(AssetsToSave);
     BuildAssets(Settings, FFMODAssetTable::AssetLookupName(), PackagePath, AssetsToSave, AssetsToDelete);
+    BuildCompactLookup(PackagePath, AssetsToSave);
     SaveAssets(AssetsToSave);
     DeleteAssets(AssetsToDelete);
 }
@@ -209,6 +212,82 @@ void FFMODAssetBuilder::BuildAssets(const UFMODSettings& InSettings, const FStri
     }
 }
 
+void FFMODAssetBuilder::BuildCompactLookup(const FString &PackagePath, TArray<UObject*>& AssetsToSave)
+{
+    if (!BankLookup)
+    {
+        return;
+    }
+
+    // The DataTables stay the editable view of the lookups, the compact lookup is rebuilt from them every time
+    TArray<UFMODCompactLookup::FAsset> Assets;
+    UPackage *AssetLookupPackage = FindPackage(nullptr, *(PackagePath + FFMODAssetTable::AssetLookupName()));
+    UDataTable *AssetLookup = AssetLookupPackage ? FindObject<UDataTable>(AssetLookupPackage, *FFMODAssetTable::AssetLookupName(), true) : nullptr;
+
+    if (AssetLookup)
+    {
+        AssetLookup->ForeachRow<FFMODAssetLookupRow>(FString(), [&Assets](const FName& Key, const FFMODAssetLookupRow& Value) {
+            UFMODCompactLookup::FAsset &Asset = Assets.AddDefaulted_GetRef();
+            Asset.StudioPath = Key.ToString();
+            Asset.PackageName = Value.PackageName;
+            Asset.AssetName = Value.AssetName;
+        });
+    }
+
+    TArray<UFMODCompactLookup::FBank> Banks;
+    BankLookup->DataTable->ForeachRow<FFMODLocalizedBankTable>(FString(), [&Banks](const FName& Key, const FFMODLocalizedBankTable& Value) {
+        UFMODCompactLookup::FBank Bank;
+        if (!Value.Banks || !FGuid::Parse(Key.ToString(), Bank.Guid))
+        {
+            return;
+        }
+
+        Value.Banks->ForeachRow<FFMODLocalizedBankRow>(FString(), [&Bank](const FName& Locale, const FFMODLocalizedBankRow& Row) {
+            Bank.Paths.Add(TPair<FString, FString>(Locale.ToString(), Row.Path));
+        });
+        Banks.Add(MoveTemp(Bank));
+    });
+
+    TMap<FGuid, TArray<FGuid>> EventBanks;
+    if (BankLookup->EventBanks)
+    {
+        BankLookup->EventBanks->ForeachRow<FFMODEventBanksRow>(FString(), [&EventBanks](const FName& Key, const FFMODEventBanksRow& Value) {
+            FGuid Guid;
+            if (FGuid::Parse(Key.ToString(), Guid))
+            {
+                EventBanks.Add(Guid, Value.Banks);
+            }
+        });
+    }
+
+    FString PackageName = PackagePath + FFMODAssetTable::CompactLookupName();
+    UPackage *Package = CreatePackage(*PackageName);
+    Package->FullyLoad();
+
+    bool bCreated = false;
+    UFMODCompactLookup *CompactLookup = FindObject<UFMODCompactLookup>(Package, *FFMODAssetTable::CompactLookupName(), true);
+
+    if (!CompactLookup)
+    {
+        CompactLookup = NewObject<UFMODCompactLookup>(Package, *FFMODAssetTable::CompactLookupName(), RF_Public | RF_Standalone | RF_MarkAsRootSet);
+        bCreated = true;
+    }
+
+    bool bModified = CompactLookup->Build(Assets, Banks, BankLookup->EventBanks ? &EventBanks : nullptr, BankLookup->MasterBankPath,
+        BankLookup->MasterAssetsBankPath, BankLookup->MasterStringsBankPath);
+
+    if (bCreated)
+    {
+        FAssetRegistryModule::AssetCreated(CompactLookup);
+    }
+
+    if (bCreated || bModified)
+    {
+        UE_LOG(LogFMOD, Log, TEXT("CompactLookup modified, %d assets and %d banks.\n"), Assets.Num(), Banks.Num());
+        AssetsToSave.AddUnique(CompactLookup);
+    }
+}
+
 void FFMODAssetBuilder::BuildBankLookup(const FString &AssetName, const FString &PackagePath, const UFMODSettings &InSettings,
     TArray<UObject*>& AssetsToSave)
 {
@@ -234,6 +313,7 @@ void FFMODAssetBuilder::BuildBankLookup(const FString &AssetName, const FString
     TArray<FName> StaleBanks(BankLookup->DataTable->GetRowNames());
 
     // Process all banks on disk
+    BankFileGuids.Reset();
     TArray<FString> BankPaths;
     FString SearchDir = InSettings.GetFullBankPath();
     IFileManager::Get().FindFilesRecursive(BankPaths, *SearchDir, TEXT("*.bank"), true, false, false);
@@ -262,6 +342,8 @@ void FFMODAssetBuilder::BuildBankLookup(const FString &AssetName, const FString
             continue;
         }
         
+        BankFileGuids.Add(BankPath, FMODUtils::ConvertGuid(BankID));
+
         FString GUID = FMODUtils::ConvertGuid(BankID).ToString(EGuidFormats::DigitsWithHyphensInBraces);
         FName OuterRowName(*GUID);
 
@@ -396,7 +478,7 @@ void FFMODAssetBuilder::BuildBankLookup(const FString &AssetName, const FString
     if (bCreated || bModified)
     {
         UE_LOG(LogFMOD, Log, TEXT("BankLookup modified.\n"));
-        AssetsToSave.Add(BankLookup);
+        AssetsToSave.AddUnique(BankLookup);
     }
 
     UE_LOG(LogFMOD, Log, TEXT("===== BankLookup =====\n"));
@@ -414,6 +496,120 @@ void FFMODAssetBuilder::BuildBankLookup(const FString &AssetName, const FString
     }
 }
 
+void FFMODAssetBuilder::BuildEventBanks(TArray<UObject*>& AssetsToSave)
+{
+    if (!BankLookup)
+    {
+        return;
+    }
+
+    bool bModified = false;
+
+    if (!BankLookup->EventBanks)
+    {
+        BankLookup->EventBanks = NewObject<UDataTable>(BankLookup, "EventBanks", RF_NoFlags);
+        BankLookup->EventBanks->RowStruct = FFMODEventBanksRow::StaticStruct();
+        bModified = true;
+    }
+
+    // Only metadata banks list events. Each one is paired with the sample data and stream banks built from it,
+    // which share its file name, so that loading an event's banks gives it everything it needs to play.
+    const FString CompanionExtensions[] = { TEXT(".assets.bank"), TEXT(".streams.bank") };
+    TMap<FGuid, TArray<FGuid>> Dependencies;
+
+    for (const TPair<FString, FGuid>& BankFile : BankFileGuids)
+    {
+        FString Stem = BankFile.Key;
+        Stem.RemoveFromEnd(TEXT(".bank"));
+        if (Stem.EndsWith(TEXT(".assets")) || Stem.EndsWith(TEXT(".streams")) || Stem.EndsWith(TEXT(".strings")))
+        {
+            continue;
+        }
+
+        FMOD::Studio::Bank* Bank = nullptr;
+        if (StudioSystem->loadBankFile(TCHAR_TO_UTF8(*BankFile.Key), FMOD_STUDIO_LOAD_BANK_NORMAL, &Bank) != FMOD_OK)
+        {
+            UE_LOG(LogFMOD, Error, TEXT("Failed to read events from bank %s."), *BankFile.Key);
+            continue;
+        }
+
+        TArray<FGuid> RequiredBanks;
+        RequiredBanks.Add(BankFile.Value);
+        for (const FString& Extension : CompanionExtensions)
+        {
+            if (const FGuid* CompanionGuid = BankFileGuids.Find(Stem + Extension))
+            {
+                RequiredBanks.Add(*CompanionGuid);
+            }
+        }
+
+        int EventCount = 0;
+        verifyfmod(Bank->getEventCount(&EventCount));
+        if (EventCount > 0)
+        {
+            TArray<FMOD::Studio::EventDescription*> Events;
+            Events.AddZeroed(EventCount);
+            verifyfmod(Bank->getEventList(Events.GetData(), EventCount, &EventCount));
+
+            for (int i = 0; i < EventCount; ++i)
+            {
+                FMOD::Studio::ID EventID;
+                if (Events[i]->getID(&EventID) == FMOD_OK)
+                {
+                    TArray<FGuid>& EventBanks = Dependencies.FindOrAdd(FMODUtils::ConvertGuid(EventID));
+                    for (const FGuid& RequiredBank : RequiredBanks)
+                    {
+                        EventBanks.AddUnique(RequiredBank);
+                    }
+                }
+            }
+        }
+
+        Bank->unload();
+    }
+
+    StudioSystem->flushCommands();
+
+    TArray<FName> StaleEvents(BankLookup->EventBanks->GetRowNames());
+
+    for (const TPair<FGuid, TArray<FGuid>>& Dependency : Dependencies)
+    {
+        FName RowName(*Dependency.Key.ToString(EGuidFormats::DigitsWithHyphensInBraces));
+        FFMODEventBanksRow* Row = BankLookup->EventBanks->FindRow<FFMODEventBanksRow>(RowName, nullptr, false);
+
+        if (Row)
+        {
+            StaleEvents.RemoveSingle(RowName);
+
+            if (Row->Banks != Dependency.Value)
+            {
+                Row->Banks = Dependency.Value;
+                bModified = true;
+            }
+        }
+        else
+        {
+            FFMODEventBanksRow NewRow{};
+            NewRow.Banks = Dependency.Value;
+            BankLookup->EventBanks->AddRow(RowName, NewRow);
+            bModified = true;
+        }
+    }
+
+    for (const FName& RowName : StaleEvents)
+    {
+        BankLookup->EventBanks->RemoveRow(RowName);
+        bModified = true;
+    }
+
+    UE_LOG(LogFMOD, Log, TEXT("Event bank dependencies: %d events.\n"), Dependencies.Num());
+
+    if (bModified)
+    {
+        AssetsToSave.AddUnique(BankLookup);
+    }
+}
+
 FString FFMODAssetBuilder::GetAssetClassName(UClass* AssetClass)
 {
     FString ClassName("");
@@ -9,7 +9,6 @@
 FFMODBankUpdateNotifier::FFMODBankUpdateNotifier()
     : bUpdateEnabled(true)
     , NextRefreshTime(FDateTime::MinValue())
-    , FileTime(FDateTime::MinValue())
     , Countdown(0.0f)
 {
 }
@@ -18,7 +17,9 @@ void FFMODBankUpdateNotifier::SetFilePath(const FString &InPath)
 {
     FilePath = InPath;
     NextRefreshTime = FDateTime::MinValue();
-    FileTime = MostRecentFileTime();
+    ChangedFiles.Reset();
+    Files.Reset();
+    ScanFiles(Files);
 }
 
 void FFMODBankUpdateNotifier::Update(float DeltaTime)
@@ -59,38 +60,62 @@ void FFMODBankUpdateNotifier::EnableUpdate(bool bEnable)
     }
 }
 
+TArray<FString> FFMODBankUpdateNotifier::TakeChangedFiles()
+{
+    TArray<FString> Result = ChangedFiles.Array();
+    ChangedFiles.Reset();
+    return Result;
+}
+
 void FFMODBankUpdateNotifier::Refresh()
 {
     if (!FilePath.IsEmpty())
     {
-        FDateTime NewFileTime = MostRecentFileTime();
+        TMap<FString, FFileState> NewFiles;
+        ScanFiles(NewFiles);
+
+        bool bChanged = false;
+
+        for (const TPair<FString, FFileState> &File : NewFiles)
+        {
+            const FFileState *OldState = Files.Find(File.Key);
+            if (!OldState || *OldState != File.Value)
+            {
+                ChangedFiles.Add(File.Key);
+                bChanged = true;
+            }
+        }
+
+        for (const TPair<FString, FFileState> &File : Files)
+        {
+            if (!NewFiles.Contains(File.Key))
+            {
+                ChangedFiles.Add(File.Key);
+                bChanged = true;
+            }
+        }
+
+        Files = MoveTemp(NewFiles);
 
-        if (NewFileTime != FileTime)
+        // Each further change restarts the countdown, so a build that writes many banks is only reloaded once
+        if (bChanged)
         {
             const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
             Countdown = (float)Settings.ReloadBanksDelay;
-            FileTime = NewFileTime;
         }
     }
 }
 
-FDateTime FFMODBankUpdateNotifier::MostRecentFileTime()
+void FFMODBankUpdateNotifier::ScanFiles(TMap<FString, FFileState> &OutFiles) const
 {
-    // Get the most recent modified timestamp of all the bank files in the directory we are watching.
-    FDateTime MostRecent = FDateTime::MinValue();
-
+    // Timestamps and sizes of all the bank files in the directory we are watching
     TArray<FString> BankPaths;
     IFileManager::Get().FindFilesRecursive(BankPaths, *FilePath, TEXT("*.bank"), true, false, false);
 
-    for (const auto& Path : BankPaths)
+    for (const FString &Path : BankPaths)
     {
-        FDateTime ModifiedTime = IFileManager::Get().GetTimeStamp(*Path);
-
-        if (ModifiedTime > MostRecent)
-        {
-            MostRecent = ModifiedTime;
-        }
+        FFileState &State = OutFiles.Add(Path);
+        State.Time = IFileManager::Get().GetTimeStamp(*Path);
+        State.Size = IFileManager::Get().FileSize(*Path);
     }
-
-    return MostRecent;
 }
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "Containers/Map.h"
+#include "Containers/Set.h"
 #include "Containers/UnrealString.h"
 #include "Misc/DateTime.h"
 #include "Delegates/Delegate.h"
@@ -16,15 +18,28 @@ public:
 
     void EnableUpdate(bool bEnable);
 
+    /** Return the bank files added, modified or removed since the last call, and forget them */
+    TArray<FString> TakeChangedFiles();
+
     FSimpleMulticastDelegate BanksUpdatedEvent;
 
 private:
+    struct FFileState
+    {
+        FDateTime Time;
+        int64 Size;
+
+        bool operator==(const FFileState &Other) const { return Time == Other.Time && Size == Other.Size; }
+        bool operator!=(const FFileState &Other) const { return !(*this == Other); }
+    };
+
     void Refresh();
-    FDateTime MostRecentFileTime();
+    void ScanFiles(TMap<FString, FFileState> &OutFiles) const;
 
     bool bUpdateEnabled;
     FString FilePath;
     FDateTime NextRefreshTime;
-    FDateTime FileTime;
+    TMap<FString, FFileState> Files;
+    TSet<FString> ChangedFiles;
     float Countdown;
 };
@@ -0,0 +1,232 @@
+// Copyright (c), Firelight Technologies Pty, Ltd.
+
+#include "FMODGenerateMapManifestsCommandlet.h"
+
+#include "FMODAssetTable.h"
+#include "FMODBankLookup.h"
+#include "FMODEvent.h"
+#include "FMODMapManifest.h"
+#include "FMODSettings.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Editor/UnrealEd/Public/FileHelpers.h"
+#include "Misc/PackageName.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFMODCommandlet, Log, All);
+
+static constexpr auto MapsParam = TEXT("maps");
+
+#if WITH_EDITOR
+static bool IsMapPackage(IAssetRegistry &AssetRegistry, FName PackageName)
+{
+    TArray<FAssetData> Assets;
+    AssetRegistry.GetAssetsByPackageName(PackageName, Assets, true);
+
+    for (const FAssetData &Asset : Assets)
+    {
+        if (Asset.IsInstanceOf(UWorld::StaticClass()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Collect the events in everything a map depends on. This finds events set on placed actors and components, in
+ * blueprints spawned by the map (such as vehicles), in animation notifies and in level sequences, without needing
+ * to know which class refers to them.
+ */
+static void CollectMapEvents(IAssetRegistry &AssetRegistry, FName MapPackage, TSet<FGuid> &Events)
+{
+    TArray<FName> Queue;
+    TSet<FName> Visited;
+
+    auto Enqueue = [&](FName PackageName) {
+        if (!Visited.Contains(PackageName) && !FPackageName::IsScriptPackage(PackageName.ToString()))
+        {
+            Visited.Add(PackageName);
+            Queue.Add(PackageName);
+        }
+    };
+
+    Enqueue(MapPackage);
+
+    while (Queue.Num() > 0)
+    {
+        FName PackageName = Queue.Pop(false);
+
+        TArray<FAssetData> Assets;
+        AssetRegistry.GetAssetsByPackageName(PackageName, Assets, true);
+
+        bool bIsMap = false;
+        for (const FAssetData &Asset : Assets)
+        {
+            if (Asset.IsInstanceOf(UFMODEvent::StaticClass()))
+            {
+                if (UFMODEvent *Event = Cast<UFMODEvent>(Asset.GetAsset()))
+                {
+                    Events.Add(Event->AssetGuid);
+                }
+            }
+            bIsMap |= Asset.IsInstanceOf(UWorld::StaticClass());
+        }
+
+        if (bIsMap)
+        {
+            // World Partition actors live in their own packages, which depend on the map rather than the other way round
+            TArray<FAssetData> ExternalActors;
+            AssetRegistry.GetAssetsByPath(FName(*ULevel::GetExternalActorsPath(PackageName.ToString())), ExternalActors, true, true);
+
+            for (const FAssetData &Actor : ExternalActors)
+            {
+                Enqueue(Actor.PackageName);
+            }
+
+            // Streaming levels are soft references, but they are part of the map
+            TArray<FName> SoftDependencies;
+            AssetRegistry.GetDependencies(PackageName, SoftDependencies, UE::AssetRegistry::EDependencyCategory::Package,
+                UE::AssetRegistry::EDependencyQuery::Soft);
+
+            for (FName Dependency : SoftDependencies)
+            {
+                if (IsMapPackage(AssetRegistry, Dependency))
+                {
+                    Enqueue(Dependency);
+                }
+            }
+        }
+
+        TArray<FName> Dependencies;
+        AssetRegistry.GetDependencies(PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package,
+            UE::AssetRegistry::EDependencyQuery::Hard);
+
+        for (FName Dependency : Dependencies)
+        {
+            Enqueue(Dependency);
+        }
+    }
+}
+#endif
+
+UFMODGenerateMapManifestsCommandlet::UFMODGenerateMapManifestsCommandlet(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+{
+}
+
+int32 UFMODGenerateMapManifestsCommandlet::Main(const FString& CommandLine)
+{
+    int32 returnCode = 0;
+
+#if WITH_EDITOR
+
+    FAssetRegistryModule& assetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(AssetRegistryConstants::ModuleName);
+    IAssetRegistry& AssetRegistry = assetRegistryModule.Get();
+
+    const UFMODSettings& Settings = *GetDefault<UFMODSettings>();
+
+    TArray<FString> Tokens, Switches;
+    TMap<FString, FString> Params;
+    ParseCommandLine(*CommandLine, Tokens, Switches, Params);
+
+    // Dependencies are needed for the whole project, not just the FMOD content
+    AssetRegistry.SearchAllAssets(true);
+
+    TArray<FName> Maps;
+    if (const FString *MapList = Params.Find(MapsParam))
+    {
+        TArray<FString> MapNames;
+        MapList->ParseIntoArray(MapNames, TEXT("+"));
+        for (const FString &MapName : MapNames)
+        {
+            Maps.Add(FName(*MapName));
+        }
+    }
+    else
+    {
+        FARFilter Filter;
+        Filter.ClassPaths.Add(UWorld::StaticClass()->GetClassPathName());
+        Filter.PackagePaths.Add(TEXT("/Game"));
+        Filter.bRecursivePaths = true;
+
+        TArray<FAssetData> MapAssets;
+        AssetRegistry.GetAssets(Filter, MapAssets);
+        for (const FAssetData &MapAsset : MapAssets)
+        {
+            Maps.AddUnique(MapAsset.PackageName);
+        }
+    }
+
+    FString PackagePath = Settings.GetFullContentPath() / FFMODAssetTable::PrivateDataPath();
+
+    FString PackageName = PackagePath + FFMODAssetTable::BankLookupName();
+    UPackage *Package = CreatePackage(*PackageName);
+    Package->FullyLoad();
+    UFMODBankLookup *BankLookup = FindObject<UFMODBankLookup>(Package, *FFMODAssetTable::BankLookupName(), true);
+
+    if (!BankLookup || !BankLookup->EventBanks)
+    {
+        UE_LOG(LogFMODCommandlet, Warning, TEXT("The bank lookup has no event dependencies, manifests will not list any banks. Run the FMODGenerateAssets commandlet first."));
+    }
+
+    PackageName = PackagePath + FFMODAssetTable::MapManifestsName();
+    Package = CreatePackage(*PackageName);
+    Package->FullyLoad();
+    UDataTable *MapManifests = FindObject<UDataTable>(Package, *FFMODAssetTable::MapManifestsName(), true);
+
+    if (!MapManifests)
+    {
+        MapManifests = NewObject<UDataTable>(Package, *FFMODAssetTable::MapManifestsName(), RF_Public | RF_Standalone | RF_MarkAsRootSet);
+        MapManifests->RowStruct = FFMODMapManifestRow::StaticStruct();
+    }
+    else if (!Params.Contains(MapsParam))
+    {
+        // Every map is being rebuilt, so drop the manifests of maps that no longer exist
+        MapManifests->EmptyTable();
+    }
+
+    for (FName Map : Maps)
+    {
+        TSet<FGuid> Events;
+        CollectMapEvents(AssetRegistry, Map, Events);
+
+        FFMODMapManifestRow Row;
+        for (const FGuid &Event : Events)
+        {
+            Row.Events.Add(Event);
+
+            const FFMODEventBanksRow *EventBanks = (BankLookup && BankLookup->EventBanks)
+                ? BankLookup->EventBanks->FindRow<FFMODEventBanksRow>(FName(*Event.ToString(EGuidFormats::DigitsWithHyphensInBraces)), nullptr, false)
+                : nullptr;
+
+            if (EventBanks)
+            {
+                for (const FGuid &Bank : EventBanks->Banks)
+                {
+                    Row.Banks.AddUnique(Bank);
+                }
+            }
+            else if (BankLookup && BankLookup->EventBanks)
+            {
+                UE_LOG(LogFMODCommandlet, Warning, TEXT("%s uses event %s, which is not in any bank."), *Map.ToString(),
+                    *Event.ToString(EGuidFormats::DigitsWithHyphensInBraces));
+            }
+        }
+
+        UE_LOG(LogFMODCommandlet, Display, TEXT("%s: %d events in %d banks."), *Map.ToString(), Row.Events.Num(), Row.Banks.Num());
+
+        MapManifests->RemoveRow(Map);
+        MapManifests->AddRow(Map, Row);
+    }
+
+    Package->MarkPackageDirty();
+    if (!UEditorLoadingAndSavingUtils::SavePackages({ Package }, false))
+    {
+        UE_LOG(LogFMODCommandlet, Error, TEXT("Failed to save %s."), *PackageName);
+        returnCode = 1;
+    }
+#endif
+
+    return returnCode;
+}
@@ -203,6 +203,9 @@ public:
     /** Build UE4 assets for FMOD Studio items */
     void ProcessBanks();
 
+    /** Build assets and reload the banks that changed on disk */
+    void ProcessChangedBanks();
+
     /** Add extensions to menu */
     void RegisterHelpMenuEntries();
     void AddFileMenuExtension(FMenuBuilder &MenuBuilder);
@@ -224,6 +227,9 @@ public:
     /** Reload banks */
     void ReloadBanks();
 
+    /** Show whether the last bank reload succeeded */
+    void ShowBankReloadNotification();
+
     /** Callback for the main frame finishing load */
     void OnMainFrameLoaded(TSharedPtr<SWindow> InRootWindow, bool bIsNewProjectWindow);
 
@@ -370,7 +376,7 @@ void FFMODStudioEditorModule::OnPostEngineInit()
     }
 
     // Bind to bank update notifier to reload banks when they change on disk
-    BankUpdateNotifier.BanksUpdatedEvent.AddRaw(this, &FFMODStudioEditorModule::ProcessBanks);
+    BankUpdateNotifier.BanksUpdatedEvent.AddRaw(this, &FFMODStudioEditorModule::ProcessChangedBanks);
 
     // Register a callback to validate settings on startup
     IMainFrameModule& MainFrameModule = FModuleManager::LoadModuleChecked<IMainFrameModule>(TEXT("MainFrame"));
@@ -391,6 +397,28 @@ void FFMODStudioEditorModule::ProcessBanks()
     }
 }
 
+void FFMODStudioEditorModule::ProcessChangedBanks()
+{
+    const UFMODSettings &Settings = *GetDefault<UFMODSettings>();
+    TArray<FString> ChangedFiles = BankUpdateNotifier.TakeChangedFiles();
+
+    if (!Settings.bIncrementalBankReload || ChangedFiles.Num() == 0 || IsRunningCommandlet() || !FApp::HasProjectName())
+    {
+        ProcessBanks();
+        return;
+    }
+
+    // The notifier already holds the state of the files on disk, so it doesn't need to be reset as a full reload does
+    BankUpdateNotifier.EnableUpdate(false);
+
+    AssetBuilder.ProcessBanks();
+    IFMODStudioModule::Get().ReloadChangedBanks(ChangedFiles);
+    BanksReloadedDelegate.Broadcast();
+    ShowBankReloadNotification();
+
+    BankUpdateNotifier.EnableUpdate(true);
+}
+
 void FFMODStudioEditorModule::RegisterHelpMenuEntries()
 {
     FToolMenuOwnerScoped OwnerScoped(this);
@@ -1239,8 +1267,11 @@ void FFMODStudioEditorModule::ReloadBanks()
     AssetBuilder.ProcessBanks();
     IFMODStudioModule::Get().ReloadBanks();
     BanksReloadedDelegate.Broadcast();
+    ShowBankReloadNotification();
+}
 
-    // Show a reload notification
+void FFMODStudioEditorModule::ShowBankReloadNotification()
+{
     TArray<FString> FailedBanks = IFMODStudioModule::Get().GetFailedBankLoads(EFMODSystemContext::Auditioning);
     FText Message;
     SNotificationItem::ECompletionState State;